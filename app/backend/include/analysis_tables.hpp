@@ -0,0 +1,49 @@
+#ifndef H_ANALYSIS_TABLES
+#define H_ANALYSIS_TABLES
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mel_filterbank.hpp"
+
+
+/**
+ * Config fields the analysis tables depend on (top_db, eps, hop etc. do not matter).
+ */
+struct AnalysisTablesKey {
+    uint32_t sample_rate = 0;
+    uint32_t fft_size = 0;
+    uint32_t num_mels = 0;
+    float fmin = 0.0f;
+    float fmax = 0.0f;
+    MelScale mel_scale = MelScale::htk;
+    bool periodic_window = false;
+
+    auto operator<=>(const AnalysisTablesKey&) const = default;
+};
+
+
+/**
+ * Read-only per-config analysis data: Hann window, sparse mel filterbank and the
+ * centre frequency of every power bin (k * sample_rate / fft_size).
+ * - the window is symmetric (N - 1 denominator) or periodic (N, scipy/librosa "hann")
+ *
+ * - shared between every extractor with the same key through acquire(); nothing
+ *   in here is written after construction, so any number of threads may read it
+ * - per-instance scratch (FFT buffers, power spectrum, mel power) stays in the
+ *   extractors; the FFT twiddles are shared the same way by the FFT backends
+ */
+struct AnalysisTables {
+    AnalysisTablesKey key;
+    std::vector<float> window;
+    MelFilterbank mel_filterbank;
+    std::vector<float> bin_frequencies;
+
+    static std::shared_ptr<const AnalysisTables> acquire(const AnalysisTablesKey& key);
+    static size_t live_count();
+};
+
+#endif // H_ANALYSIS_TABLES
@@ -1,15 +1,90 @@
 #ifndef AUDIO_ENGINE_H
 #define AUDIO_ENGINE_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "capture_source.hpp"
+#include "capture_telemetry.hpp"
 #include "miniaudio.h"
+#include "spsc_queue.hpp"
+#include "spsc_ring.hpp"
+#include "wake_event.hpp"
 
+// defaults for AudioEngineConfig
 static constexpr ma_uint32 SAMPLE_RATE = 48000;     // 48khz 
 static constexpr ma_uint32 CHANNELS = 1;            // mono audio
 static constexpr ma_uint32 RECORD_SEC = 10;         // 10 seconds of recording
 static constexpr ma_uint32 CHUNK_FRAMES = 1024;     // audio samples to process at a time
+static constexpr ma_uint32 MAX_VIEW_FRAMES = 4 * CHUNK_FRAMES;  // largest zero-copy chunk view
+static constexpr size_t MAX_PENDING_GAPS = 64;      // discontinuities buffered between reads
+static constexpr ma_uint32 MIX_BLOCK_FRAMES = 1024; // multichannel frames downmixed per step
+
+/**
+ * Capture format and buffering, chosen at runtime.
+ * - period_frames/periods of 0 let the backend pick, the performance profile then
+ *   decides between small (low_latency) and large (conservative) periods
+ * - file and synthetic sources use period_frames as their block size (10 ms when 0)
+ * - multichannel input is downmixed on the audio thread into the mono analysis ring;
+ *   channel_weights picks the mix (empty = equal weights, one-hot = a single input)
+ *   and split_channels lists channels that also get a raw per-channel ring
+ */
+struct AudioEngineConfig {
+    ma_uint32 sample_rate = SAMPLE_RATE;
+    ma_uint32 channels = CHANNELS;
+    std::vector<float> channel_weights;
+    std::vector<ma_uint32> split_channels;
+    ma_uint32 ring_frames = SAMPLE_RATE * RECORD_SEC;
+    ma_uint32 max_view_frames = MAX_VIEW_FRAMES;
+
+    ma_uint32 period_frames = 0;
+    ma_uint32 periods = 0;
+    ma_performance_profile performance_profile = ma_performance_profile_low_latency;
+};
+
+/**
+ * What the backend actually gave us, filled in by AudioEngine::init().
+ * - the engine always delivers `sample_rate`/`channels`; the internal values are the
+ *   device's native format that miniaudio converts from
+ */
+struct NegotiatedFormat {
+    ma_uint32 sample_rate = 0;
+    ma_uint32 channels = 0;
+    ma_uint32 internal_sample_rate = 0;
+    ma_uint32 internal_channels = 0;
+    ma_uint32 period_frames = 0;        // in internal frames
+    ma_uint32 periods = 0;
+
+    double period_ms() const;
+    double latency_ms() const;          // whole device buffer: period_frames * periods
+};
+
+/**
+ * A point in the capture stream where frames were dropped because the ring was full.
+ */
+struct Discontinuity {
+    uint64_t sequence = 0;          // 1-based, increases with every gap since start
+    uint64_t frame_position = 0;    // stream frame before which the gap occurred
+    uint64_t frames_lost = 0;
+};
+
+/**
+ * Metadata describing a chunk handed out by AudioEngine.
+ */
+struct ChunkInfo {
+    uint64_t sequence = 0;          // chunk index since start
+    uint64_t first_frame = 0;       // stream position of the first frame in the chunk
+    bool discontinuity = false;     // frames were lost before or inside this chunk
+    uint64_t gap_sequence = 0;      // sequence of the latest gap seen so far, 0 if none
+    uint64_t frames_lost = 0;       // frames lost in the gaps reported with this chunk
+};
 
 class AudioEngine {
 public:
@@ -18,18 +93,49 @@ public:
         ring_buffer_failure = 1,
         device_failure = 2,
         context_failure = 3,
+        source_failure = 4,
+        config_failure = 5,
     };
 
-    AudioEngine(ma_uint32 capture_device_index);
+    AudioEngine(ma_uint32 capture_device_index, const AudioEngineConfig& config = {});
+    AudioEngine(const CaptureSourceConfig& source_config, const AudioEngineConfig& config = {});
     ~AudioEngine();
 
     InitResult init();
     void start();
     void stop();
 
-    bool read_chunk(float* out, ma_uint32 frames);
+    bool read_chunk(float* out, ma_uint32 frames, ChunkInfo* info = nullptr);
+    std::span<const float> acquire_chunk(ma_uint32 frames, ChunkInfo* info = nullptr);
+    void release_chunk(ma_uint32 frames);
+    ChunkInfo next_chunk_info();
+
+    bool wait_for_frames(ma_uint32 frames, std::chrono::nanoseconds timeout = WakeEvent::WAIT_FOREVER);
+    bool read_chunk_blocking(
+        float* out,
+        ma_uint32 frames,
+        std::chrono::nanoseconds timeout = WakeEvent::WAIT_FOREVER,
+        ChunkInfo* info = nullptr
+    );
+    std::span<const float> acquire_chunk_blocking(
+        ma_uint32 frames,
+        std::chrono::nanoseconds timeout = WakeEvent::WAIT_FOREVER,
+        ChunkInfo* info = nullptr
+    );
+
+    SpscRing* get_ring_buffer();
+    CaptureStats get_stats() const;
+    const AudioEngineConfig& get_config() const;
+    const NegotiatedFormat& get_negotiated_format() const;
+    bool is_source_exhausted() const;
+    size_t available_frames() const;
+
+    bool read_channel_chunk(ma_uint32 channel, float* out, ma_uint32 frames);
+    std::span<const float> acquire_channel_chunk(ma_uint32 channel, ma_uint32 frames);
+    void release_channel_chunk(ma_uint32 channel, ma_uint32 frames);
 
-    ma_pcm_rb* get_ring_buffer();
+    void set_chunk_listener(WakeEvent* listener, ma_uint32 frames);
+    std::optional<std::chrono::steady_clock::time_point> get_stream_start_time() const;
 
     static std::vector<std::string> get_capture_devices();
 
@@ -44,16 +150,81 @@ private:
         ma_uint32 frame_count
     );
 
+    bool init_channel_mixing();
+    InitResult init_device();
+    InitResult init_pull_source();
+    void pump_source();
+
+    ma_uint32 write_frames(const float* input, ma_uint32 frame_count);
+    void write_frames_lossless(const float* input, ma_uint32 frame_count);
+    const float* mix_block(const float* input, ma_uint32 frame_count);
+    SpscRing* channel_ring(ma_uint32 channel);
+    void notify_consumer();
+    void mark_stream_start(ma_uint32 frame_count);
+    void collect_chunk_info(ma_uint32 frames, ChunkInfo* info);
+
 private:
-    ma_context context{};
+    CaptureSourceConfig source;
+    AudioEngineConfig engine_config;
+    NegotiatedFormat negotiated;
+
     ma_device audio_device{};
-    ma_pcm_rb ring_buffer{};
-    ma_uint32 device_index;
+
+    // file and synthetic sources are all ma_data_source, read by the pump thread
+    ma_decoder decoder{};
+    ma_waveform waveform{};
+    ma_noise noise{};
+    ma_data_source* pull_source = nullptr;
+    std::thread pump_thread;
+    std::atomic<bool> pump_running{false};
+    std::atomic<bool> source_exhausted{false};
+
+    // mono analysis signal (downmix of all channels)
+    SpscRing ring_buffer;
+
+    // multichannel path, sized in init() so the audio thread never allocates
+    struct ChannelRing {
+        ma_uint32 channel = 0;
+        std::unique_ptr<SpscRing> ring;
+    };
+    bool mix_passthrough = true;
+    std::vector<float> mix_weights;
+    std::vector<float> mix_scratch;
+    std::vector<float> split_scratch;
+    std::vector<float*> split_outputs;
+    std::vector<ChannelRing> channel_rings;
+
+    SpscQueue<Discontinuity, MAX_PENDING_GAPS> pending_gaps;
+
+    // consumer wake-up, the audio thread only signals once `wake_threshold` samples are buffered
+    WakeEvent data_ready;
+    std::atomic<size_t> wake_threshold{SIZE_MAX};
+
+    // optional shared wake-up for consumers that watch several engines at once
+    WakeEvent* chunk_listener = nullptr;
+    size_t chunk_listener_threshold = SIZE_MAX;
+
+    // steady_clock time at which frame 0 of the stream arrived, 0 until it does
+    std::atomic<int64_t> stream_start_ns{0};
+
+    CaptureTelemetry telemetry;
+
+    // producer (audio thread) state
+    uint64_t gaps_recorded = 0;
+    uint64_t unreported_frames_lost = 0;
+
+    // consumer state
+    uint64_t chunk_sequence = 0;
+    uint64_t last_gap_sequence = 0;
+    ChunkInfo current_chunk;
+    bool current_chunk_valid = false;
+
     InitResult init_result = InitResult::context_failure;
 
-    bool context_initialized = false;
     bool device_initialized = false;
-    bool ring_buffer_initialized = false;
+    bool decoder_initialized = false;
+    bool waveform_initialized = false;
+    bool noise_initialized = false;
 };
 
 #endif // AUDIO_ENGINE_H
\ No newline at end of file
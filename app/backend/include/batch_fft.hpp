@@ -0,0 +1,49 @@
+#ifndef H_BATCH_FFT
+#define H_BATCH_FFT
+
+#include <cstdint>
+#include <vector>
+
+static constexpr uint32_t BATCH_FFT_LANES = 4;
+
+
+/**
+ * Four real FFTs of one size in lockstep (kissfft built with USE_SIMD).
+ *
+ * - lane j is an independent transform: consecutive frames of one signal, or the
+ *   same frame of four channels or streams
+ * - samples are stored interleaved by lane, so every butterfly is one __m128 op
+ *   and the twiddles are shared by the four transforms
+ * - same algorithm and operation order as the scalar kiss_fftr, lane results are
+ *   bit-identical to it
+ * - without SSE the lanes are transformed one after another by the scalar kiss_fftr
+ */
+class BatchFft4 {
+public:
+    explicit BatchFft4(uint32_t size);
+    ~BatchFft4();
+
+    void load(const float* const frames[BATCH_FFT_LANES]);
+    void execute();
+    void spectra(float* const bins[BATCH_FFT_LANES]) const;
+
+    uint32_t size() const;
+    static bool simd_available();
+
+    BatchFft4(const BatchFft4&) = delete;
+    BatchFft4& operator=(const BatchFft4&) = delete;
+
+private:
+    uint32_t fft_size;
+    void* config = nullptr;
+
+    // lane-interleaved: sample n of lane j at [n * 4 + j]; bin k holds re[4] then im[4]
+    float* time_data = nullptr;
+    float* freq_data = nullptr;
+
+    // scalar fallback only
+    std::vector<float> lane_time;
+    std::vector<float> lane_freq;
+};
+
+#endif // H_BATCH_FFT
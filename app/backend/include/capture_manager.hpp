@@ -0,0 +1,116 @@
+#ifndef H_CAPTURE_MANAGER
+#define H_CAPTURE_MANAGER
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "audio_engine.hpp"
+#include "feature_extractor.hpp"
+#include "resampler.hpp"
+#include "thread_pool.hpp"
+#include "wake_event.hpp"
+
+/**
+ * Features extracted from one chunk of one input.
+ * - `timestamp_sec` is the capture time of the chunk's first frame, measured from
+ *   CaptureManager::start(), so chunks from different inputs share one timeline
+ * - `frames` holds `frame_count` rows of `frame_size` values, row-major, and is only
+ *   valid during the callback
+ * - `descriptors` holds one SpectralDescriptors per row when the input's
+ *   FeatureExtractorConfig sets spectral_descriptors, and is empty otherwise
+ * - `final_chunk` marks the end of a finite source: that chunk holds whatever was left
+ *   (possibly less than a chunk, possibly nothing) plus the resampler's filter tail
+ */
+struct InputFeatures {
+    size_t input = 0;
+    ChunkInfo chunk;
+    double timestamp_sec = 0.0;
+    std::span<const float> frames;
+    std::span<const SpectralDescriptors> descriptors;
+    size_t frame_count = 0;
+    uint32_t frame_size = 0;
+    bool final_chunk = false;
+};
+
+using FeatureCallback = std::function<void(const InputFeatures&)>;
+
+
+/**
+ * Concurrent capture from several inputs with a shared feature extraction pool.
+ *
+ * - every input is an AudioEngine with its own ring, all device inputs share the
+ *   DeviceRegistry context
+ * - one dispatcher thread sleeps on a single WakeEvent that every engine signals when
+ *   a chunk is ready, and hands chunks to a fixed ThreadPool
+ * - chunks of one input are processed in order and never concurrently (its
+ *   FeatureExtractor is stateful); different inputs run in parallel
+ * - the feature callback runs on pool threads and must be thread-safe
+ * - an input whose FeatureExtractorConfig::sample_rate differs from the capture rate
+ *   is resampled between the ring and its extractor (e.g. 48 kHz capture -> 22050 Hz,
+ *   the rate the CNN was trained on)
+ */
+class CaptureManager {
+public:
+    explicit CaptureManager(
+        const AudioEngineConfig& engine_config = {},
+        size_t worker_threads = 0,
+        ma_uint32 chunk_frames = CHUNK_FRAMES
+    );
+    ~CaptureManager();
+
+    size_t add_input(const CaptureSourceConfig& source, const FeatureExtractorConfig& features);
+    AudioEngine::InitResult init();
+
+    void start(FeatureCallback callback);
+    void stop();
+    bool wait_until_drained(std::chrono::nanoseconds timeout = WakeEvent::WAIT_FOREVER);
+
+    size_t input_count() const;
+    AudioEngine& engine(size_t input);
+
+    CaptureManager(const CaptureManager&) = delete;
+    CaptureManager& operator=(const CaptureManager&) = delete;
+
+private:
+    struct Input {
+        std::unique_ptr<AudioEngine> engine;
+        std::unique_ptr<FeatureExtractor> extractor;
+        std::unique_ptr<PolyphaseResampler> resampler;
+        std::vector<float> resampled;
+        std::vector<float> features;
+        std::vector<SpectralDescriptors> descriptors;
+        std::atomic<bool> busy{false};
+        std::atomic<bool> flushed{false};   // the final chunk of an exhausted source is done
+    };
+
+    void dispatch_loop();
+    bool has_ready_input() const;
+    bool has_work(const Input& input) const;
+    bool is_drained() const;
+    void process_chunk(size_t index);
+    void process_final_chunk(size_t index);
+    void extract(size_t index, const ChunkInfo& info, const float* samples, size_t sample_count, bool final_chunk);
+    double chunk_timestamp(const Input& input, const ChunkInfo& chunk) const;
+
+private:
+    AudioEngineConfig engine_config;
+    ma_uint32 chunk_frames;
+
+    std::vector<std::unique_ptr<Input>> inputs;
+    ThreadPool pool;
+
+    WakeEvent chunk_ready;
+    std::thread dispatcher;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> jobs_in_flight{0};
+
+    FeatureCallback on_features;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+#endif // H_CAPTURE_MANAGER
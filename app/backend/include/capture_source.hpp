@@ -0,0 +1,99 @@
+#ifndef H_CAPTURE_SOURCE
+#define H_CAPTURE_SOURCE
+
+#include <cstdint>
+#include <string>
+
+#include "miniaudio.h"
+
+/**
+ * Where AudioEngine pulls its audio from.
+ *
+ * - device: a live capture device, frames arrive on miniaudio's real-time callback
+ * - file: any WAV/MP3/FLAC file, decoded with ma_decoder and converted to the engine format
+ * - synthetic: a generated test signal (miniaudio waveform or noise generator)
+ *
+ * File and synthetic sources are pumped by an engine-owned thread into the same
+ * ring buffer the device callback writes to, so consumers cannot tell them apart.
+ */
+enum class CaptureSourceKind {
+    device,
+    file,
+    synthetic,
+};
+
+enum class SourcePacing {
+    real_time,              // deliver one period per period of wall-clock time, like a device
+    as_fast_as_possible,    // deliver as fast as the consumer drains the ring, never drop
+};
+
+enum class SyntheticWaveform {
+    sine,
+    square,
+    triangle,
+    sawtooth,
+    white_noise,
+    silence,
+};
+
+struct CaptureSourceConfig {
+    CaptureSourceKind kind = CaptureSourceKind::device;
+
+    // device, selected by stable registry ID when set, otherwise by index
+    ma_uint32 device_index = 0;
+    std::string device_id;
+
+    // file
+    std::string file_path;
+    bool loop = false;
+
+    // synthetic
+    SyntheticWaveform waveform = SyntheticWaveform::sine;
+    double frequency = 440.0;
+    double amplitude = 0.5;
+    uint64_t duration_frames = 0;       // 0 runs until stopped
+
+    // file + synthetic
+    SourcePacing pacing = SourcePacing::real_time;
+
+    static CaptureSourceConfig device(ma_uint32 index) {
+        CaptureSourceConfig config;
+        config.kind = CaptureSourceKind::device;
+        config.device_index = index;
+        return config;
+    }
+
+    static CaptureSourceConfig device_by_id(const std::string& stable_id) {
+        CaptureSourceConfig config;
+        config.kind = CaptureSourceKind::device;
+        config.device_id = stable_id;
+        return config;
+    }
+
+    static CaptureSourceConfig file(const std::string& path, SourcePacing pacing = SourcePacing::real_time) {
+        CaptureSourceConfig config;
+        config.kind = CaptureSourceKind::file;
+        config.file_path = path;
+        config.pacing = pacing;
+        return config;
+    }
+
+    static CaptureSourceConfig synthetic(
+        SyntheticWaveform waveform,
+        double frequency,
+        double amplitude,
+        SourcePacing pacing = SourcePacing::real_time,
+        uint64_t duration_frames = 0
+    ) {
+        CaptureSourceConfig config;
+        config.kind = CaptureSourceKind::synthetic;
+        config.waveform = waveform;
+        config.frequency = frequency;
+        config.amplitude = amplitude;
+        config.pacing = pacing;
+        config.duration_frames = duration_frames;
+        return config;
+    }
+};
+
+#endif // H_CAPTURE_SOURCE
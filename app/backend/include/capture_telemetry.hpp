@@ -0,0 +1,78 @@
+#ifndef H_CAPTURE_TELEMETRY
+#define H_CAPTURE_TELEMETRY
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// callback time histogram, bucket i covers [2^(i-1), 2^i) / 256 of the callback's period,
+// bucket 0 is anything under 1/256 and the last bucket collects everything past 2 periods
+static constexpr size_t CALLBACK_TIMING_BUCKETS = 11;
+
+/**
+ * Point-in-time copy of the capture path counters.
+ */
+struct CaptureStats {
+    uint64_t callbacks = 0;
+    uint64_t frames_captured = 0;       // frames written to the ring
+    uint64_t frames_dropped = 0;        // frames lost because the ring was full
+    uint64_t overrun_callbacks = 0;     // callbacks that dropped at least one frame
+
+    uint64_t ring_fill_frames = 0;      // fill level after the latest callback
+    uint64_t ring_high_water_frames = 0;
+    uint64_t ring_capacity_frames = 0;
+
+    uint64_t last_callback_ns = 0;
+    uint64_t max_callback_ns = 0;
+    uint64_t over_budget_callbacks = 0; // callbacks that took longer than their own period
+    std::array<uint64_t, CALLBACK_TIMING_BUCKETS> callback_time_histogram{};
+
+    static double bucket_upper_fraction(size_t bucket);
+};
+
+
+/**
+ * Lock-free counters updated by the real-time capture thread.
+ *
+ * - single writer: the audio thread owns every field and updates them with plain
+ *   relaxed load/store pairs, no read-modify-write or locks on the hot path
+ * - any thread may take a snapshot() at any time without disturbing the writer
+ */
+class CaptureTelemetry {
+public:
+    void set_ring_capacity(uint64_t frames);
+
+    // audio thread
+    void record_callback(
+        uint64_t frames_written,
+        uint64_t frames_dropped,
+        uint64_t ring_fill_frames,
+        uint64_t elapsed_ns,
+        uint64_t period_ns
+    );
+
+    // any thread
+    CaptureStats snapshot() const;
+    void reset();
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount);
+
+private:
+    std::atomic<uint64_t> callbacks{0};
+    std::atomic<uint64_t> frames_captured{0};
+    std::atomic<uint64_t> frames_dropped{0};
+    std::atomic<uint64_t> overrun_callbacks{0};
+
+    std::atomic<uint64_t> ring_fill{0};
+    std::atomic<uint64_t> ring_high_water{0};
+    std::atomic<uint64_t> ring_capacity{0};
+
+    std::atomic<uint64_t> last_callback_ns{0};
+    std::atomic<uint64_t> max_callback_ns{0};
+    std::atomic<uint64_t> over_budget_callbacks{0};
+    std::array<std::atomic<uint64_t>, CALLBACK_TIMING_BUCKETS> histogram{};
+};
+
+#endif // H_CAPTURE_TELEMETRY
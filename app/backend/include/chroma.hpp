@@ -0,0 +1,99 @@
+#ifndef H_CHROMA
+#define H_CHROMA
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static constexpr uint32_t NUM_CHROMA = 12;
+
+
+struct ChromaConfig {
+    uint32_t sample_rate = 22050;
+    uint32_t fft_size = 2048;
+
+    float tuning = 0.0f;            // offset from A440 in fractions of a chroma bin, [-0.5, 0.5)
+    float weight_floor = 1e-3f;     // filter weights below this fraction of the largest are dropped
+};
+
+
+/**
+ * Pitch-class profile of one power spectrum, the chroma_stft stage.
+ *
+ * - librosa.filters.chroma: Gaussian bumps around each pitch class, unit L2 norm per
+ *   FFT bin, weighted by a two-octave Gaussian around octave 5, rows starting at C;
+ *   only the fft_size / 2 + 1 non-aliased bins are used
+ * - the dense 12 x bins matrix is mostly near-zero tails; weights under weight_floor
+ *   are dropped and each row is kept as runs of contiguous bins, one dispatched simd
+ *   dot per run (under a third of the dense multiply-adds at n_fft 2048)
+ * - input is FeatureExtractor::compute_power_spectrum(), the transform the mel path
+ *   already ran; output is scaled to a peak of 1 (norm=inf), silence stays zero
+ * - tuning shifts the reference from A440 to 440 * 2^(tuning / 12); set_tuning()
+ *   rebuilds the runs, TuningEstimator provides the value
+ */
+class ChromaExtractor {
+public:
+    explicit ChromaExtractor(const ChromaConfig& config = {});
+
+    void compute(const float* power, float* chroma) const;
+
+    void set_tuning(float tuning);
+    float get_tuning() const;
+    size_t weight_count() const;
+    const ChromaConfig& get_config() const;
+
+private:
+    void build_filters();
+
+private:
+    struct ChromaRun {
+        uint32_t chroma;
+        uint32_t first_bin;
+        uint32_t length;
+        uint32_t offset;    // into weights
+    };
+
+    ChromaConfig config;
+    std::vector<ChromaRun> runs;
+    std::vector<float> weights;
+};
+
+
+/**
+ * Streaming librosa.estimate_tuning over power spectra.
+ *
+ * - piptrack peaks per frame: local maxima above 0.1 of the frame's maximum between
+ *   150 Hz and 4 kHz, frequency by parabolic interpolation
+ * - each peak's deviation from the equal-tempered grid goes into a histogram of
+ *   `resolution`-wide bins over [-0.5, 0.5); estimate() is the fullest bin's left
+ *   edge, 0 before any peak
+ * - librosa keeps peaks at or above the median magnitude of the whole clip; streamed,
+ *   the median is taken per frame
+ */
+class TuningEstimator {
+public:
+    TuningEstimator(uint32_t sample_rate, uint32_t fft_size, float resolution = 0.01f);
+
+    void push(const float* power);
+    float estimate() const;
+    void reset();
+
+    uint64_t peak_count() const;
+
+private:
+    uint32_t sample_rate;
+    uint32_t fft_size;
+    uint32_t first_bin;     // [first_bin, end_bin): 150 Hz <= f < 4 kHz
+    uint32_t end_bin;
+    float resolution;
+
+    std::vector<uint32_t> histogram;
+    uint64_t peaks = 0;
+
+    // per-frame scratch
+    std::vector<float> peak_pitches;
+    std::vector<float> peak_magnitudes;
+    std::vector<float> median_scratch;
+};
+
+#endif // H_CHROMA
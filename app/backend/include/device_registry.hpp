@@ -0,0 +1,80 @@
+#ifndef H_DEVICE_REGISTRY
+#define H_DEVICE_REGISTRY
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "miniaudio.h"
+
+/**
+ * A capture device as seen by the registry.
+ * - `stable_id` is derived from the backend device ID, so it survives re-enumeration,
+ *   index shifts and other devices being plugged in or out
+ */
+struct CaptureDeviceInfo {
+    std::string stable_id;
+    std::string name;
+    ma_device_id id{};
+    bool is_default = false;
+};
+
+
+/**
+ * Process-wide audio context and cached capture device list.
+ *
+ * - the ma_context is created lazily on first use and shared by every AudioEngine,
+ *   so backend probing is paid once per process
+ * - enumeration results are cached; a background monitor re-enumerates periodically
+ *   and bumps generation() when devices appear or disappear
+ * - all methods are thread-safe
+ */
+class DeviceRegistry {
+public:
+    static DeviceRegistry& instance();
+
+    ma_context* get_context();
+    std::vector<CaptureDeviceInfo> get_capture_devices();
+    std::optional<CaptureDeviceInfo> find_device(const std::string& stable_id);
+    std::optional<CaptureDeviceInfo> device_at(size_t index);
+
+    bool refresh();
+    uint64_t generation() const;
+
+    void start_hotplug_monitor(std::chrono::milliseconds interval = std::chrono::milliseconds(2000));
+    void stop_hotplug_monitor();
+
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+private:
+    DeviceRegistry() = default;
+    ~DeviceRegistry();
+
+    bool ensure_context();
+    bool enumerate_locked();
+    static std::string make_stable_id(const ma_context& context, const ma_device_id& id);
+
+private:
+    std::mutex mutex;
+    ma_context context{};
+    bool context_initialized = false;
+    bool context_failed = false;
+
+    std::vector<CaptureDeviceInfo> devices;
+    bool enumerated = false;
+    std::atomic<uint64_t> list_generation{0};
+
+    std::thread monitor_thread;
+    std::mutex monitor_mutex;
+    std::condition_variable monitor_cv;
+    bool monitor_running = false;
+};
+
+#endif // H_DEVICE_REGISTRY
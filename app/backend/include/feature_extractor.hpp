@@ -3,7 +3,13 @@
 
 #include <vector>
 #include <cstdint>
-#include "kiss_fftr.h"
+#include <memory>
+#include <span>
+#include "analysis_tables.hpp"
+#include "batch_fft.hpp"
+#include "fft_backend.hpp"
+#include "frame_assembler.hpp"
+#include "spectral_descriptors.hpp"
 
 
 struct FeatureExtractorConfig {
@@ -18,36 +24,99 @@ struct FeatureExtractorConfig {
     float eps = 1e-10f;
 
     float silence_threshold = 1e-4f;
+
+    MelScale mel_scale = MelScale::htk;
+    bool periodic_window = false;   // true for scipy/librosa's default "hann"
+
+    // for_each_frame() also computes SpectralDescriptors, read with frame_descriptors()
+    bool spectral_descriptors = false;
+
+    FftBackendKind fft_backend = FftBackendKind::kiss;
 };
 
 
+/**
+ * Streaming log-mel extractor.
+ *
+ * - samples are buffered across calls, a frame of `num_mels` values is emitted for
+ *   every `hop_size` samples once `fft_size` samples are available
+ * - frames come straight out of a circular FrameAssembler, so the cost per sample
+ *   does not depend on the chunk size handed in
+ * - the span and visitor overloads are allocation-free (the span overload only
+ *   allocates if `out` is too small to take every frame of a chunk)
+ * - the vector-of-vectors overload allocates per frame and is kept for convenience
+ * - SpectralDescriptors per frame: the span overload writes row i's into
+ *   `descriptors[i]` when that span is given; with `spectral_descriptors` set the
+ *   visitor reads the current frame's from frame_descriptors() during the call
+ */
 class FeatureExtractor {
 public:
     FeatureExtractor(const FeatureExtractorConfig& config);
     ~FeatureExtractor();
 
     std::vector<std::vector<float>> process_samples(const float* input, uint32_t num_samples);
+    size_t process_samples(const float* input, uint32_t num_samples, std::span<float> out,
+                           std::span<SpectralDescriptors> descriptors = {});
 
-private:
-    void build_hann_window();
-    void build_mel_filterbank();
-    std::vector<float> compute_frame(const float* frame);
+    template <typename Visitor>
+    size_t for_each_frame(const float* input, uint32_t num_samples, Visitor&& visit);
+
+    void compute_frame(const float* frame, float* out, SpectralDescriptors* descriptors = nullptr);
+    void compute_mel_power(const float* frame, float* out);
+    std::span<const float> compute_power_spectrum(const float* frame);
+    void project_mel_power(const float* power, float* out) const;
+    void compute_frames4(const float* const frames[BATCH_FFT_LANES], float* const out[BATCH_FFT_LANES],
+                         SpectralDescriptors* descriptors = nullptr);
+
+    const SpectralDescriptors& frame_descriptors() const;
+    std::span<const float> bin_frequencies() const;
+
+    size_t max_frames(uint32_t num_samples) const;
+    size_t pending_frames() const;
+    const FeatureExtractorConfig& get_config() const;
+    FftBackendKind get_fft_backend() const;
 
-    static float hz_to_mel(float hz);
-    static float mel_to_hz(float mel);
+    FeatureExtractor(const FeatureExtractor&) = delete;
+    FeatureExtractor& operator=(const FeatureExtractor&) = delete;
+
+private:
+    void project_frame(const float* power, float* out);
+    SpectralDescriptors* streaming_descriptors();
 
 private:
     FeatureExtractorConfig config;
 
-    std::vector<float> window;
-    std::vector<float> fft_input;
-    std::vector<kiss_fft_cpx> fft_output;
+    // window and filterbank are shared with every extractor of the same shape
+    std::shared_ptr<const AnalysisTables> tables;
+    std::unique_ptr<FftBackend> fft;
     std::vector<float> power_spectrum;
-    std::vector<std::vector<float>> mel_filterbank;
 
-    std::vector<float> overlap_buffer;
+    // 4-wide kissfft, built by the first compute_frames4 call when the backend is kissfft
+    std::unique_ptr<BatchFft4> batch_fft;
+    std::vector<float> batch_windowed;
+    std::vector<float> batch_bins;
+
+    std::vector<float> mel_power;
 
-    kiss_fftr_cfg fft_config;
+    std::vector<float> magnitude_scratch;
+    SpectralDescriptors last_descriptors;
+
+    FrameAssembler assembler;
+    std::vector<float> frame_scratch;
 };
 
+
+/**
+ * Feed samples and call `visit(std::span<const float>)` for every completed frame.
+ * - the span is only valid during the call
+ * - returns the number of frames visited
+ */
+template <typename Visitor>
+size_t FeatureExtractor::for_each_frame(const float* input, uint32_t num_samples, Visitor&& visit) {
+    return assembler.for_each_frame(input, num_samples, [&](const float* frame, size_t) {
+        compute_frame(frame, frame_scratch.data(), streaming_descriptors());
+        visit(std::span<const float>(frame_scratch));
+    });
+}
+
 #endif // H_FEATURE_EXTRACTOR
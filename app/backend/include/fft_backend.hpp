@@ -0,0 +1,62 @@
+#ifndef H_FFT_BACKEND
+#define H_FFT_BACKEND
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class FftBackendKind {
+    automatic,  // opt-in: fastest available backend for the size, measured once per process
+    kiss,       // default
+    fftw,       // FFTW3 single precision, only when built against <fftw3.h>
+};
+
+
+/**
+ * Real-to-complex forward FFT of one fixed size.
+ *
+ * - callers write `size()` samples into input(), call execute(), and read
+ *   size() / 2 + 1 interleaved (re, im) bins from output()
+ * - the buffers are owned (and aligned) by the backend, so no copies are made
+ * - unnormalised, e^{-i...} sign convention, same as kiss_fftr
+ * - one instance per thread; different instances may run concurrently
+ * - twiddles (kissfft) and plans (FFTW) are shared by all instances of one size,
+ *   an instance only owns its buffers
+ */
+class FftBackend {
+public:
+    explicit FftBackend(uint32_t size) : fft_size(size) {}
+    virtual ~FftBackend() = default;
+
+    virtual float* input() = 0;
+    virtual const float* output() const = 0;
+    virtual void execute() = 0;
+    virtual FftBackendKind kind() const = 0;
+
+    uint32_t size() const { return fft_size; }
+
+    FftBackend(const FftBackend&) = delete;
+    FftBackend& operator=(const FftBackend&) = delete;
+
+protected:
+    uint32_t fft_size;
+};
+
+
+struct FftBenchmarkResult {
+    FftBackendKind kind = FftBackendKind::kiss;
+    double ns_per_transform = 0.0;
+};
+
+std::unique_ptr<FftBackend> make_fft_backend(FftBackendKind kind, uint32_t size);
+bool fft_backend_available(FftBackendKind kind);
+const char* fft_backend_name(FftBackendKind kind);
+
+std::vector<FftBenchmarkResult> benchmark_fft_backends(uint32_t size);
+FftBackendKind fastest_fft_backend(uint32_t size);
+
+std::string default_fftw_wisdom_file();
+void set_fftw_wisdom_file(const std::string& path);
+
+#endif // H_FFT_BACKEND
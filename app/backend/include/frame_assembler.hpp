@@ -0,0 +1,103 @@
+#ifndef H_FRAME_ASSEMBLER
+#define H_FRAME_ASSEMBLER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * Sliding analysis-frame history over a sample stream.
+ *
+ * - circular buffer of `capacity` samples (a power of two), every sample is stored
+ *   twice, at `i` and `i + capacity`, so any window of up to `capacity` samples
+ *   starting anywhere in the ring is contiguous in memory
+ * - a frame is handed out as a plain pointer, advancing by a hop never moves data,
+ *   so the cost per sample is constant whatever the chunk size
+ * - write() only accepts what fits; drain frames between writes or reserve() more
+ * - for_each_frame() / fill_frames() are the two streaming loops the extractors
+ *   share: `emit(frame, index)` gets every completed frame before it is advanced past
+ */
+class FrameAssembler {
+public:
+    FrameAssembler(uint32_t frame_size, uint32_t hop_size);
+
+    size_t write(const float* input, size_t count);
+    void reserve(size_t samples);
+
+    bool has_frame() const;
+    const float* frame() const;
+    void advance();
+
+    size_t buffered() const;
+    size_t writable() const;
+    size_t max_frames(size_t more_samples) const;
+    void reset();
+
+    template <typename Emit>
+    size_t for_each_frame(const float* input, size_t count, Emit&& emit);
+    template <typename Emit>
+    size_t fill_frames(const float* input, size_t count, size_t max_frames, Emit&& emit);
+
+private:
+    uint32_t frame_size;
+    uint32_t hop_size;
+
+    size_t capacity = 0;
+    size_t mask = 0;
+    std::vector<float> buffer;  // 2 * capacity
+
+    // absolute stream positions, read_pos may run ahead of write_pos when hop > frame
+    uint64_t write_pos = 0;
+    uint64_t read_pos = 0;
+};
+
+
+/**
+ * Write `count` samples and emit every frame they complete.
+ * - writes and frames are interleaved, so the buffer never has to grow
+ * - returns the number of frames emitted
+ */
+template <typename Emit>
+size_t FrameAssembler::for_each_frame(const float* input, size_t count, Emit&& emit) {
+    size_t frames = 0;
+    size_t offset = 0;
+    do {
+        offset += write(input + offset, count - offset);
+        while (has_frame()) {
+            emit(frame(), frames++);
+            advance();
+        }
+    } while (offset < count);
+    return frames;
+}
+
+
+/**
+ * Write `count` samples and emit at most `max_frames` frames.
+ * - frames that do not fit stay buffered for the next call, the buffer grows to
+ *   keep the rest of the input
+ * - returns the number of frames emitted
+ */
+template <typename Emit>
+size_t FrameAssembler::fill_frames(const float* input, size_t count, size_t max_frames, Emit&& emit) {
+    size_t frames = 0;
+    size_t offset = 0;
+    while (true) {
+        while (frames < max_frames && has_frame()) {
+            emit(frame(), frames++);
+            advance();
+        }
+        if (offset == count) break;
+
+        size_t accepted = write(input + offset, count - offset);
+        if (accepted == 0) {
+            reserve(buffered() + (count - offset));
+            continue;
+        }
+        offset += accepted;
+    }
+    return frames;
+}
+
+#endif // H_FRAME_ASSEMBLER
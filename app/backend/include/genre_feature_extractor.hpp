@@ -0,0 +1,134 @@
+#ifndef H_GENRE_FEATURE_EXTRACTOR
+#define H_GENRE_FEATURE_EXTRACTOR
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "chroma.hpp"
+#include "feature_extractor.hpp"
+#include "frame_assembler.hpp"
+#include "hpss.hpp"
+#include "mfcc.hpp"
+#include "running_stats.hpp"
+#include "tempo_estimator.hpp"
+
+static constexpr size_t GENRE_FEATURE_COUNT = 57;
+
+
+/**
+ * Analysis parameters of data/audio_features.csv (librosa defaults).
+ * - the CSV was computed at the clips' native 44.1 kHz: its tempo values all sit on
+ *   the 60 * 44100 / (512 * lag) grid
+ */
+struct GenreFeatureConfig {
+    uint32_t sample_rate = 44100;
+    uint32_t n_fft = 2048;
+    uint32_t hop_length = 512;
+    uint32_t n_mels = 128;
+    uint32_t n_mfcc = 20;
+    uint32_t hpss_kernel = 31;
+
+    float amin = 1e-10f;
+    float top_db = 80.0f;
+
+    bool estimate_tuning = true;    // chroma_stft(tuning=None); false keeps A440
+};
+
+
+/**
+ * One clip's row of data/audio_features.csv, chroma_stft_mean through mfcc20_var.
+ */
+struct GenreFeatures {
+    std::array<float, GENRE_FEATURE_COUNT> values{};
+
+    std::vector<float> to_row() const;
+    static const std::array<std::string, GENRE_FEATURE_COUNT>& column_names();
+};
+
+
+/**
+ * GTZAN-style clip features, the 57 columns the genre classifier is trained on.
+ *
+ * - one STFT (periodic Hann, zero centre padding) through FeatureExtractor; every
+ *   spectral feature is derived from its power spectrum, no frame is transformed twice:
+ *   - chroma_stft: ChromaExtractor, at the tuning TuningEstimator finds in the clip
+ *   - spectral centroid, bandwidth, rolloff: compute_spectral_descriptors()
+ *   - harmony / perceptr: frame RMS of the HPSS components (MedianHpss)
+ *   - log-mel (Slaney, 128 bands, dB floored top_db below the peak) feeds both
+ *     the MFCCs and the onset envelope behind the tempo estimate
+ * - rms and zero_crossing_rate come from the time-domain frames
+ * - _mean / _var are over all frames (population variance, numpy's np.var); chroma
+ *   pools its 12 bins
+ * - the tuning is estimated over the first TUNING_FRAMES frames (about 1.5 s), whose
+ *   power spectra are held until then and replayed into the chroma statistics;
+ *   librosa estimates over the whole clip, the two agree unless the tuning drifts
+ *
+ * - streamed: push() takes any chunking, every frame updates RunningStats as it
+ *   completes, so memory stays constant however long the clip; snapshot() reads the
+ *   frames complete so far, finish() adds the end padding and the held-back
+ *   frames (HPSS lag, tempo tail) and returns the clip's row
+ * - streaming puts the top_db floor below the loudest frame so far rather than the
+ *   clip's peak; the two differ only for log-mel bands more than top_db below a
+ *   later, louder frame (e.g. a quiet fade-in)
+ */
+class GenreFeatureExtractor {
+public:
+    explicit GenreFeatureExtractor(const GenreFeatureConfig& config = {});
+
+    GenreFeatures extract(const float* samples, size_t num_samples);
+
+    void push(const float* samples, size_t num_samples);
+    GenreFeatures snapshot() const;
+    GenreFeatures finish();
+    void reset();
+
+    size_t frame_count(size_t num_samples) const;
+    uint64_t frames_processed() const;
+    const GenreFeatureConfig& get_config() const;
+
+private:
+    static FeatureExtractorConfig extractor_config(const GenreFeatureConfig& config);
+    void write(const float* samples, size_t num_samples);
+    void process_frame(const float* frame);
+    float zero_crossing_rate(const float* frame) const;
+    void settle_tuning(size_t buffered);
+
+private:
+    GenreFeatureConfig config;
+    FeatureExtractor extractor;
+    MfccStage mfcc;
+    MedianHpss hpss;
+    TempoEstimator tempo;
+    FrameAssembler assembler;
+    ChromaExtractor chroma;
+    TuningEstimator tuning;
+
+    // power spectra of the frames before the tuning is settled, TUNING_FRAMES x bins
+    std::vector<float> tuning_frames;
+    bool tuning_settled = false;
+
+    std::vector<float> magnitude_scratch;
+    std::vector<float> padding;             // n_fft / 2 zeros, the centred STFT's edges
+
+    // log-mel dB of the last MEL_HISTORY frames (unfloored), ring by frame number
+    std::vector<float> mel_history;
+    std::vector<float> mel_frame;
+    float peak_db = 0.0f;
+
+    // per frame: rms, centroid, bandwidth, rolloff, zcr, then the MFCCs
+    std::vector<float> frame_values;
+    RunningStats frame_stats;
+    RunningStats chroma_stats;
+    RunningStats hpss_stats;
+
+    uint64_t samples_in = 0;
+    uint64_t frames = 0;
+    float first_sample = 0.0f;
+    float last_sample = 0.0f;
+    bool finished = false;
+};
+
+#endif // H_GENRE_FEATURE_EXTRACTOR
@@ -0,0 +1,73 @@
+#ifndef H_HPSS
+#define H_HPSS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * RMS of one frame's harmonic and percussive components.
+ */
+struct HpssFrameRms {
+    float harmonic = 0.0f;
+    float percussive = 0.0f;
+};
+
+
+/**
+ * Median-filtering harmonic/percussive separation (librosa.decompose.hpss defaults),
+ * streamed over power spectra and reduced to per-frame component RMS.
+ *
+ * - harmonic enhancement: median of each bin's magnitude over `kernel_size` frames;
+ *   percussive: median over `kernel_size` neighbouring bins of one frame; both with
+ *   scipy.ndimage's "reflect" edges
+ * - soft masks H^2 / (H^2 + P^2) and P^2 / (H^2 + P^2) (power 2, margin 1)
+ * - the component RMS comes straight from its masked power spectrum (Parseval,
+ *   divided by the window energy), so neither component is inverted and
+ *   re-transformed
+ * - a frame needs kernel_size / 2 later frames, so push() lags by that many frames
+ *   and flush() drains the tail once the stream has ended
+ * - medians of interior windows come from sorted windows that slide by one value
+ *   (one frame per bin, one bin per frame) instead of a selection per window
+ * - keeps kernel_size + 1 magnitude frames, allocation-free after construction
+ */
+class MedianHpss {
+public:
+    MedianHpss(uint32_t fft_size, float window_power_sum, uint32_t kernel_size = 31);
+
+    bool push(const float* power, HpssFrameRms& out);
+    bool flush(HpssFrameRms& out);
+    void reset();
+
+    uint32_t latency_frames() const;
+
+private:
+    void emit(uint64_t frame, uint64_t total, HpssFrameRms& out);
+    const float* magnitudes(uint64_t frame) const;
+
+private:
+    uint32_t fft_size;
+    uint32_t bins;
+    uint32_t kernel;
+    uint32_t half;
+    float rms_scale;    // 1 / (fft_size * sum of squared window)
+
+    // last kernel + 1 magnitude frames, ring indexed by frame number: the extra
+    // frame is the one leaving the time window when it slides
+    std::vector<float> history;
+    uint64_t frames_in = 0;
+    uint64_t frames_emitted = 0;
+
+    // per bin, the sorted time window of frame `sorted_frame` (valid only for
+    // frames whose window needs no reflection)
+    std::vector<float> sorted_time;
+    uint64_t sorted_frame = 0;
+    bool sorted_valid = false;
+
+    std::vector<float> harmonic;
+    std::vector<float> window_values;   // reflected edge windows
+    std::vector<float> sorted_bins;     // frequency window sliding over the interior bins
+};
+
+#endif // H_HPSS
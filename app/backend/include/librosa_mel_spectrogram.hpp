@@ -0,0 +1,60 @@
+#ifndef H_LIBROSA_MEL_SPECTROGRAM
+#define H_LIBROSA_MEL_SPECTROGRAM
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "feature_extractor.hpp"
+#include "offline_feature_extractor.hpp"
+
+
+/**
+ * librosa.feature.melspectrogram + librosa.power_to_db(ref=np.max) parameters,
+ * defaults as used by app/AI/inference.py.
+ */
+struct LibrosaMelConfig {
+    uint32_t sample_rate = 22050;
+    uint32_t n_fft = 2048;
+    uint32_t hop_length = 512;
+    uint32_t n_mels = 128;
+
+    float fmin = 0.0f;
+    float fmax = -1.0f;     // sample_rate / 2
+
+    bool center = true;     // zero-pad n_fft / 2 on both sides (librosa >= 0.10 pad_mode="constant")
+
+    float amin = 1e-10f;
+    float top_db = 80.0f;
+};
+
+
+/**
+ * Whole-signal log-mel spectrogram with librosa's numerics, the CNN input.
+ *
+ * - periodic Hann window, Slaney mel scale with slaney norm, power 2, centre padding
+ * - dB is relative to the maximum of the whole spectrogram (ref=np.max) and floored
+ *   at -top_db, so unlike FeatureExtractor the frames are only final once the whole
+ *   signal has been seen
+ * - row i of the result is frame i, i.e. the transpose of librosa's (n_mels, t) array
+ * - float32 throughout; agrees with librosa to within a few hundredths of a dB
+ */
+class LibrosaMelSpectrogram {
+public:
+    explicit LibrosaMelSpectrogram(const LibrosaMelConfig& config = {});
+
+    FeatureMatrix compute(const float* signal, size_t num_samples);
+
+    size_t frame_count(size_t num_samples) const;
+    const LibrosaMelConfig& get_config() const;
+
+private:
+    static FeatureExtractorConfig extractor_config(const LibrosaMelConfig& config);
+
+private:
+    LibrosaMelConfig config;
+    FeatureExtractor extractor;
+    std::vector<float> padded;
+};
+
+#endif // H_LIBROSA_MEL_SPECTROGRAM
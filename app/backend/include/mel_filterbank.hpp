@@ -0,0 +1,39 @@
+#ifndef H_MEL_FILTERBANK
+#define H_MEL_FILTERBANK
+
+#include <cstdint>
+#include <vector>
+
+
+enum class MelScale {
+    htk,        // 2595 log10(1 + f / 700), triangles on the FFT bin grid, unit area
+    slaney,     // librosa.filters.mel defaults: Slaney's scale, exact-frequency triangles, slaney norm
+};
+
+
+/**
+ * Triangular mel filterbank over the `fft_size / 2 + 1` power bins, kept sparse.
+ *
+ * - filter m covers bins [start, start + length) and its non-zero weights sit
+ *   contiguously at weights[offset, offset + length), so projecting a frame
+ *   touches about two bins per filter instead of every bin
+ * - neighbouring triangles overlap at most pairwise, so weights.size() stays below
+ *   2 * (fft_size / 2 + 1)
+ */
+struct MelBand {
+    uint32_t start = 0;
+    uint32_t length = 0;
+    uint32_t offset = 0;
+};
+
+struct MelFilterbank {
+    std::vector<MelBand> bands;
+    std::vector<float> weights;
+
+    void project(const float* power, float* mel_power) const;
+};
+
+MelFilterbank build_mel_filterbank(uint32_t sample_rate, uint32_t fft_size, uint32_t num_mels, float fmin, float fmax,
+                                   MelScale scale = MelScale::htk);
+
+#endif // H_MEL_FILTERBANK
@@ -0,0 +1,67 @@
+#ifndef H_MFCC
+#define H_MFCC
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+struct MfccConfig {
+    uint32_t num_mels = 40;
+    uint32_t num_coefficients = 20;
+
+    float lifter = 0.0f;        // librosa-style sinusoidal lifter, 0 disables
+    bool deltas = false;        // append delta and delta-delta coefficients
+    uint32_t delta_width = 9;   // odd window of the Savitzky-Golay derivative filters
+};
+
+
+/**
+ * MFCCs from log-mel frames, one frame in, one frame out, allocation-free.
+ *
+ * - orthonormal DCT-II (scipy dct(type=2, norm="ortho"), as librosa.feature.mfcc)
+ *   kept as a precomputed num_coefficients x num_mels matrix with the lifter folded
+ *   into its rows, so a frame is one GEMV of dispatched simd dot products
+ * - deltas follow librosa.feature.delta (mode="interp"): Savitzky-Golay first and
+ *   second derivative filters over `delta_width` frames (polyorder = derivative
+ *   order); the first and last delta_width / 2 frames take the derivative of the fit
+ *   over the first / last full window, as savgol_filter(mode="interp") does
+ * - frame 0 needs the whole first window, so push() lags by delta_width - 1 frames
+ *   and flush() drains the tail
+ * - a stream shorter than delta_width, which librosa rejects, gets zero deltas
+ * - output per frame: [c_0..c_{n-1}] or [c | delta | delta-delta], see frame_size()
+ */
+class MfccStage {
+public:
+    explicit MfccStage(const MfccConfig& config);
+
+    void compute(const float* log_mel, float* cepstrum) const;
+
+    bool push(const float* log_mel, float* out);
+    bool flush(float* out);
+    void reset();
+
+    uint32_t frame_size() const;
+    uint32_t latency_frames() const;
+    const MfccConfig& get_config() const;
+
+private:
+    void emit(uint64_t frame, float* out) const;
+
+private:
+    MfccConfig config;
+    uint32_t half_width = 0;
+
+    std::vector<float> dct;             // num_coefficients x num_mels, row-major, liftered
+    std::vector<float> delta_weights;   // delta_width taps, frame t + n at [n + half_width]
+    std::vector<float> delta2_weights;
+
+    // last delta_width + delta_width / 2 cepstra, ring indexed by frame number: the
+    // frame being emitted and the window its deltas are taken from
+    std::vector<float> history;
+    uint32_t history_frames = 0;
+    uint64_t frames_pushed = 0;
+    uint64_t frames_emitted = 0;
+};
+
+#endif // H_MFCC
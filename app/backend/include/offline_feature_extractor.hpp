@@ -0,0 +1,53 @@
+#ifndef H_OFFLINE_FEATURE_EXTRACTOR
+#define H_OFFLINE_FEATURE_EXTRACTOR
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "feature_extractor.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * Row-major log-mel matrix, `frames` rows of `num_mels` values.
+ */
+struct FeatureMatrix {
+    std::vector<float> data;
+    size_t frames = 0;
+    uint32_t num_mels = 0;
+
+    std::span<const float> row(size_t frame) const;
+};
+
+
+/**
+ * Whole-signal feature extraction spread over a thread pool (batch jobs, files).
+ *
+ * - frames are independent once the whole signal is in memory, so the frame range
+ *   is cut into blocks that workers claim from a shared counter
+ * - every worker owns a FeatureExtractor, i.e. its own FFT plan and scratch buffers
+ * - each frame is computed by the same code as the streaming path (four hops per
+ *   4-wide FFT pass, see compute_frames4) and written to its own row, so the result
+ *   is identical to serial mode and always in order
+ */
+class OfflineFeatureExtractor {
+public:
+    explicit OfflineFeatureExtractor(const FeatureExtractorConfig& config, size_t thread_count = 0);
+
+    FeatureMatrix process(const float* signal, size_t num_samples);
+    size_t thread_count() const;
+
+    static size_t frame_count(const FeatureExtractorConfig& config, size_t num_samples);
+
+    OfflineFeatureExtractor(const OfflineFeatureExtractor&) = delete;
+    OfflineFeatureExtractor& operator=(const OfflineFeatureExtractor&) = delete;
+
+private:
+    FeatureExtractorConfig config;
+    ThreadPool pool;
+    std::vector<std::unique_ptr<FeatureExtractor>> extractors;
+};
+
+#endif // H_OFFLINE_FEATURE_EXTRACTOR
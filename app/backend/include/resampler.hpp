@@ -0,0 +1,67 @@
+#ifndef H_RESAMPLER
+#define H_RESAMPLER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+static constexpr uint32_t MAX_RESAMPLER_PHASES = 4096; // caps the filter bank size for awkward ratios
+
+struct ResamplerConfig {
+    uint32_t input_rate = 48000;
+    uint32_t output_rate = 22050;
+
+    uint32_t taps_per_phase = 160;  // filter length per output sample
+    float kaiser_beta = 8.0f;       // ~80 dB stopband attenuation
+};
+
+
+/**
+ * Streaming rational-ratio resampler (Kaiser-windowed sinc, polyphase form).
+ *
+ * - the ratio is reduced to output/input = L/M (48000 -> 22050 is 147/320), every one
+ *   of the L phases gets its own contiguous, pre-reversed set of taps
+ * - each output sample is one dot product over `taps_per_phase` input samples, no
+ *   zero-stuffed samples are ever computed
+ * - the cutoff is placed so the stopband starts at the lower Nyquist frequency; the
+ *   transition band below it narrows with taps_per_phase (48000 -> 22050 at the
+ *   defaults: flat to about 9.5 kHz, 80 dB down from 11025 Hz)
+ * - state carries across calls, so any chunking of the input gives the same output
+ * - the output lags the input by latency_frames() output samples; flush() emits the
+ *   filter tail at the end of a stream
+ */
+class PolyphaseResampler {
+public:
+    explicit PolyphaseResampler(const ResamplerConfig& config);
+
+    size_t process(const float* input, size_t frames, float* output);
+    size_t process(const float* input, size_t frames, std::vector<float>& output);
+    size_t flush(std::vector<float>& output);
+
+    size_t max_output_frames(size_t input_frames) const;
+    size_t latency_frames() const;
+    void reset();
+
+    uint32_t upsample_factor() const;
+    uint32_t downsample_factor() const;
+    const ResamplerConfig& get_config() const;
+
+private:
+    void build_filter_bank();
+
+private:
+    ResamplerConfig config;
+    uint32_t up = 1;        // L
+    uint32_t down = 1;      // M
+    uint32_t taps = 0;
+
+    // taps of phase p live at [p * taps, (p + 1) * taps), reversed for a forward dot product
+    std::vector<float> filter_bank;
+
+    // input not yet fully consumed, prefixed by taps - 1 samples of history
+    std::vector<float> history;
+    uint32_t phase = 0;
+};
+
+#endif // H_RESAMPLER
@@ -0,0 +1,46 @@
+#ifndef H_RUNNING_STATS
+#define H_RUNNING_STATS
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+/**
+ * Streaming per-dimension mean and variance of feature vectors (Welford).
+ *
+ * - push() is one dispatched simd::welford_update over all dimensions: the
+ *   running mean and sum of squared deviations are updated in place, so there is
+ *   no sum-of-squares cancellation however long or offset the stream; the state is
+ *   double, a float mean stalls once value / count drops below its ulp
+ * - mean() / variance() may be read at any point and cost nothing to keep up to date
+ * - merge() folds in another instance (Chan et al. pairwise update), e.g. per-thread
+ *   or per-block partial statistics of one clip
+ * - memory is two doubles per dimension, whatever the stream length; push() and
+ *   merge() do not allocate
+ */
+class RunningStats {
+public:
+    explicit RunningStats(size_t dimensions = 1);
+
+    void push(const float* values);
+    void push(float value);
+    void merge(const RunningStats& other);
+    void reset();
+
+    uint64_t count() const;
+    size_t dimensions() const;
+
+    std::span<const double> mean() const;
+    double variance(size_t dimension, uint32_t ddof = 0) const;
+    void variances(float* out, uint32_t ddof = 0) const;
+    void pooled(float& mean_out, float& variance_out) const;
+
+private:
+    std::vector<double> means;
+    std::vector<double> m2;
+    uint64_t samples = 0;
+};
+
+#endif // H_RUNNING_STATS
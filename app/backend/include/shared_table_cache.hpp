@@ -0,0 +1,52 @@
+#ifndef H_SHARED_TABLE_CACHE
+#define H_SHARED_TABLE_CACHE
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+/**
+ * Process-wide cache of immutable tables, shared by reference count.
+ *
+ * - acquire() hands out the live table for `key`, or builds one and remembers it
+ * - the cache only holds weak references, so a table is freed together with its
+ *   last user and rebuilt if the key is needed again
+ * - building happens under the cache lock, concurrent first users of a key wait
+ *   for one build instead of racing to make duplicates
+ */
+template <typename Key, typename Table>
+class SharedTableCache {
+public:
+    template <typename Build>
+    std::shared_ptr<const Table> acquire(const Key& key, Build&& build) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            if (std::shared_ptr<const Table> live = it->second.lock()) return live;
+        }
+
+        std::erase_if(entries, [](const auto& entry) { return entry.second.expired(); });
+
+        std::shared_ptr<const Table> table = build();
+        entries[key] = table;
+        return table;
+    }
+
+    size_t live_count() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = 0;
+        for (const auto& entry : entries) {
+            if (!entry.second.expired()) ++count;
+        }
+        return count;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<Key, std::weak_ptr<const Table>> entries;
+};
+
+#endif // H_SHARED_TABLE_CACHE
@@ -0,0 +1,108 @@
+#ifndef H_SIMD_KERNELS
+#define H_SIMD_KERNELS
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Vectorised inner loops shared by the capture and analysis paths.
+ *
+ * - the instruction set is picked once at runtime from what the CPU supports:
+ *   AVX-512 > AVX2+FMA > SSE2 on x86-64, NEON on ARM, scalar everywhere else
+ * - set_isa() forces a specific table (tests, benchmarks); it is not meant to be
+ *   called while other threads are running kernels
+ * - all kernels are allocation-free and safe to call on the real-time audio thread
+ * - results match the scalar table to within float rounding (FMA, summation order,
+ *   and a polynomial log in the dB kernel), not bit for bit
+ */
+namespace simd {
+
+    enum class Isa {
+        scalar,
+        sse2,
+        avx2,
+        avx512,
+        neon,
+    };
+
+    // out[i] = sum_c weights[c] * interleaved[i * channels + c]
+    void downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out);
+
+    // outs[c][i] = interleaved[i * channels + c], channels with a null output are skipped
+    void deinterleave(const float* interleaved, size_t frames, uint32_t channels, float* const* outs);
+
+    // sum_i a[i] * b[i]
+    float dot(const float* a, const float* b, size_t n);
+
+    // out[i] = frame[i] * window[i], returns sum_i |frame[i]|
+    float apply_window(const float* frame, const float* window, float* out, size_t n);
+
+    // out[k] = re[k]^2 + im[k]^2 for `bins` interleaved (re, im) pairs
+    void power_spectrum(const float* complex_bins, size_t bins, float* out);
+
+    // out[i] = 10 * log10(power[i] + eps), returns max_i out[i]
+    float power_to_db(const float* power, size_t n, float eps, float* out);
+
+    struct SpectralSums {
+        float magnitude = 0.0f;         // sum_k m[k], m = sqrt(power)
+        float weighted_freq = 0.0f;     // sum_k m[k] * freqs[k]
+        float power = 0.0f;             // sum_k max(power[k], amin)
+        float log_power = 0.0f;         // sum_k ln(max(power[k], amin))
+
+        SpectralSums& operator+=(const SpectralSums& other) {
+            magnitude += other.magnitude;
+            weighted_freq += other.weighted_freq;
+            power += other.power;
+            log_power += other.log_power;
+            return *this;
+        }
+    };
+
+    // magnitude[k] = sqrt(power[k]) and the moments of SpectralSums, in one sweep over `bins`
+    SpectralSums spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude);
+
+    // one Welford step per dimension, in double: d = x[i] - mean[i]; mean[i] += d * inv_count; m2[i] += d * (x[i] - mean[i])
+    void welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2);
+
+    bool isa_supported(Isa isa);
+    bool set_isa(Isa isa);
+    Isa active_isa();
+    const char* isa_name(Isa isa);
+    const char* isa_name();
+
+    namespace detail {
+
+        struct KernelTable {
+            Isa isa;
+            void (*downmix)(const float*, size_t, uint32_t, const float*, float*);
+            void (*deinterleave)(const float*, size_t, uint32_t, float* const*);
+            float (*dot)(const float*, const float*, size_t);
+            float (*apply_window)(const float*, const float*, float*, size_t);
+            void (*power_spectrum)(const float*, size_t, float*);
+            float (*power_to_db)(const float*, size_t, float, float*);
+            SpectralSums (*spectral_sums)(const float*, const float*, size_t, float, float*);
+            void (*welford_update)(const float*, size_t, double, double*, double*);
+        };
+
+        // tables compiled into this build, nullptr when the architecture does not match
+        const KernelTable* scalar_table();
+        const KernelTable* sse2_table();
+        const KernelTable* avx2_table();
+        const KernelTable* avx512_table();
+        const KernelTable* neon_table();
+
+        // scalar loops, also used by the vector tables for their tails
+        void scalar_downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out);
+        void scalar_deinterleave(const float* interleaved, size_t first, size_t frames, uint32_t channels, float* const* outs);
+        float scalar_dot(const float* a, const float* b, size_t n);
+        float scalar_apply_window(const float* frame, const float* window, float* out, size_t n);
+        void scalar_power_spectrum(const float* complex_bins, size_t bins, float* out);
+        float scalar_power_to_db(const float* power, size_t n, float eps, float* out);
+        SpectralSums scalar_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude);
+        void scalar_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2);
+
+    } // namespace detail
+
+} // namespace simd
+
+#endif // H_SIMD_KERNELS
@@ -0,0 +1,29 @@
+#ifndef H_SIMD_LOG_CONSTANTS
+#define H_SIMD_LOG_CONSTANTS
+
+/**
+ * Constants of the vectorised logf shared by every SIMD table (internal to the
+ * simd_kernels_*.cpp files).
+ *
+ * - cephes logf: log(m * 2^e) with m in [sqrt(1/2), sqrt(2)), ~1 ulp over normal floats
+ */
+namespace simd::detail {
+
+    static constexpr float LOG_SQRTHF = 0.707106781186547524f;
+    static constexpr float LOG_P0 = 7.0376836292e-2f;
+    static constexpr float LOG_P1 = -1.1514610310e-1f;
+    static constexpr float LOG_P2 = 1.1676998740e-1f;
+    static constexpr float LOG_P3 = -1.2420140846e-1f;
+    static constexpr float LOG_P4 = 1.4249322787e-1f;
+    static constexpr float LOG_P5 = -1.6668057665e-1f;
+    static constexpr float LOG_P6 = 2.0000714765e-1f;
+    static constexpr float LOG_P7 = -2.4999993993e-1f;
+    static constexpr float LOG_P8 = 3.3333331174e-1f;
+    static constexpr float LOG_Q1 = -2.12194440e-4f;
+    static constexpr float LOG_Q2 = 0.693359375f;
+    static constexpr float DB_PER_NEPER = 4.3429448190325175f;   // 10 / ln(10)
+    static constexpr float MIN_NORMAL = 1.17549435e-38f;
+
+} // namespace simd::detail
+
+#endif // H_SIMD_LOG_CONSTANTS
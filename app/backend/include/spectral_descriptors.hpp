@@ -0,0 +1,28 @@
+#ifndef H_SPECTRAL_DESCRIPTORS
+#define H_SPECTRAL_DESCRIPTORS
+
+#include <cstddef>
+
+
+/**
+ * Per-frame shape of the magnitude spectrum, librosa.feature defaults.
+ *
+ * - centroid: magnitude-weighted mean frequency (spectral_centroid)
+ * - bandwidth: magnitude-weighted standard deviation around it (spectral_bandwidth, p = 2)
+ * - rolloff: lowest bin frequency holding 85% of the summed magnitude (spectral_rolloff)
+ * - flatness: geometric over arithmetic mean of the power, floored at 1e-10 (spectral_flatness)
+ * - all frequencies in Hz
+ */
+struct SpectralDescriptors {
+    float centroid = 0.0f;
+    float bandwidth = 0.0f;
+    float rolloff = 0.0f;
+    float flatness = 0.0f;
+};
+
+static constexpr float SPECTRAL_ROLLOFF_PERCENT = 0.85f;
+static constexpr float SPECTRAL_FLATNESS_AMIN = 1e-10f;
+
+SpectralDescriptors compute_spectral_descriptors(const float* power, const float* freqs, size_t bins, float* magnitude_scratch);
+
+#endif // H_SPECTRAL_DESCRIPTORS
@@ -0,0 +1,55 @@
+#ifndef H_SPSC_QUEUE
+#define H_SPSC_QUEUE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed-capacity lock-free single-producer/single-consumer queue of small records.
+ *
+ * - used to pass out-of-band events (e.g. capture discontinuities) from the
+ *   real-time audio thread to the consumer alongside the sample ring
+ * - `Capacity` must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // producer: returns false when the queue is full
+    bool push(const T& item) {
+        uint64_t write_pos = head.load(std::memory_order_relaxed);
+        if (write_pos - tail.load(std::memory_order_acquire) == Capacity) return false;
+
+        items[write_pos & (Capacity - 1)] = item;
+        head.store(write_pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: next item without removing it, nullptr when empty
+    const T* front() const {
+        uint64_t read_pos = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == read_pos) return nullptr;
+        return &items[read_pos & (Capacity - 1)];
+    }
+
+    // consumer: drop the item returned by front()
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // not thread-safe, only call while neither side is running
+    void clear() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<T, Capacity> items{};
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+};
+
+#endif // H_SPSC_QUEUE
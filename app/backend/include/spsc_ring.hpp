@@ -0,0 +1,64 @@
+#ifndef H_SPSC_RING
+#define H_SPSC_RING
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Lock-free single-producer/single-consumer ring of float samples.
+ *
+ * - capacity is rounded up to a power of two so positions wrap with a mask
+ * - the first `max_view` samples are mirrored past the end of the storage, so any
+ *   read of up to `max_view` samples is contiguous and can be handed out as a span
+ * - head (producer) and tail (consumer) live on separate cache lines
+ */
+class SpscRing {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    SpscRing() = default;
+
+    bool init(size_t min_capacity, size_t max_view);
+    void reset();
+
+    // producer side
+    size_t write(const float* src, size_t count);
+    size_t available_write() const;
+
+    // consumer side
+    std::span<const float> read_view(size_t count) const;
+    size_t read(float* dest, size_t count);
+    void consume(size_t count);
+    size_t available_read() const;
+
+    uint64_t write_position() const;
+    uint64_t read_position() const;
+
+    size_t capacity() const { return ring_capacity; }
+    size_t max_view() const { return view_limit; }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+private:
+    void copy_in(uint64_t position, const float* src, size_t count);
+
+private:
+    std::vector<float> storage;
+    size_t ring_capacity = 0;
+    size_t mask = 0;
+    size_t view_limit = 0;
+
+    // written by the producer, read by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;
+
+    // written by the consumer, read by the producer
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{0};
+    mutable uint64_t cached_head = 0;
+};
+
+#endif // H_SPSC_RING
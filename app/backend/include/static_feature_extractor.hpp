@@ -0,0 +1,349 @@
+#ifndef H_STATIC_FEATURE_EXTRACTOR
+#define H_STATIC_FEATURE_EXTRACTOR
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "analysis_tables.hpp"
+#include "feature_extractor.hpp"
+#include "frame_assembler.hpp"
+#include "simd_kernels.hpp"
+
+
+namespace static_features {
+
+inline constexpr double PI = 3.14159265358979323846;
+
+/**
+ * cos/sin usable in constant expressions (std::cos is not constexpr before C++26).
+ * - range-reduced to [-pi, pi], then a Taylor series run to convergence, exact to a
+ *   few ulp of double which is far below the float tables built from it
+ */
+constexpr double reduce_angle(double x) {
+    double turns = x / (2.0 * PI);
+    long long whole = static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5);
+    return x - 2.0 * PI * double(whole);
+}
+
+constexpr double cos(double x) {
+    x = reduce_angle(x);
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 40; ++n) {
+        term *= -x * x / double((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sin(double x) {
+    x = reduce_angle(x);
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 40; ++n) {
+        term *= -x * x / double((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+
+/**
+ * Everything about an N-point real FFT frame that does not depend on the signal.
+ * - the real transform runs as an N/2-point complex radix-2 FFT on the even/odd
+ *   samples followed by a split pass (same scheme as kiss_fftr)
+ * - stage twiddles are stored per stage, contiguously, so each butterfly loop
+ *   walks them with unit stride: stage `half` starts at index half - 1
+ */
+template <uint32_t N>
+struct RealFftTables {
+    static constexpr uint32_t M = N / 2;
+
+    std::array<float, N> window{};              // symmetric Hann, as FeatureExtractor
+    std::array<float, N> periodic_window{};     // config.periodic_window
+    std::array<uint32_t, M> bit_reverse{};
+    std::array<float, M> stage_cos{};
+    std::array<float, M> stage_sin{};
+    std::array<float, M> split_cos{};           // e^{-2 pi i k / N}, k < M
+    std::array<float, M> split_sin{};
+};
+
+template <uint32_t N>
+constexpr RealFftTables<N> make_real_fft_tables() {
+    constexpr uint32_t M = N / 2;
+    RealFftTables<N> t;
+
+    for (uint32_t i = 0; i < N; ++i) {
+        t.window[i] = float(0.5 * (1.0 - cos(2.0 * PI * i / (N - 1))));
+        t.periodic_window[i] = float(0.5 * (1.0 - cos(2.0 * PI * i / N)));
+    }
+
+    uint32_t bits = 0;
+    while ((1u << bits) < M) ++bits;
+    for (uint32_t i = 0; i < M; ++i) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        t.bit_reverse[i] = r;
+    }
+
+    for (uint32_t half = 1; half < M; half *= 2) {
+        for (uint32_t j = 0; j < half; ++j) {
+            double phase = -PI * j / half;
+            t.stage_cos[half - 1 + j] = float(cos(phase));
+            t.stage_sin[half - 1 + j] = float(sin(phase));
+        }
+    }
+
+    for (uint32_t k = 0; k < M; ++k) {
+        double phase = -2.0 * PI * k / N;
+        t.split_cos[k] = float(cos(phase));
+        t.split_sin[k] = float(sin(phase));
+    }
+
+    return t;
+}
+
+} // namespace static_features
+
+
+/**
+ * Log-mel extractor with the frame geometry fixed at compile time.
+ *
+ * - same pipeline and output as FeatureExtractor (window, FFT, power, sparse mel,
+ *   dB with top_db floor), within float rounding of the different FFT
+ * - Hann window, bit-reversal order and every twiddle are constexpr tables, the
+ *   FFT is an in-class radix-2 transform whose loop bounds are all constants, and
+ *   the scratch buffers are fixed-size members, so nothing is sized or looked up
+ *   at run time
+ * - sample rate, fmin/fmax, top_db, eps and the silence gate still come from the
+ *   config; fft_size, hop_size and num_mels are taken from the template
+ * - use LiveFeatureExtractor / CnnFeatureExtractor for the production shapes and
+ *   FeatureExtractor for anything else
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+class StaticFeatureExtractor {
+    static_assert(FftSize >= 4 && (FftSize & (FftSize - 1)) == 0, "FFT size must be a power of two");
+    static_assert(Hop > 0, "hop size must be positive");
+    static_assert(NumMels > 0, "need at least one mel band");
+
+public:
+    static constexpr uint32_t fft_size = FftSize;
+    static constexpr uint32_t hop_size = Hop;
+    static constexpr uint32_t num_mels = NumMels;
+    static constexpr uint32_t num_bins = FftSize / 2 + 1;
+
+    explicit StaticFeatureExtractor(const FeatureExtractorConfig& c = {})
+        : config(c), assembler(FftSize, Hop) {
+        config.fft_size = FftSize;
+        config.hop_size = Hop;
+        config.num_mels = NumMels;
+        if (config.fmax < 0.0f) config.fmax = 0.5f * config.sample_rate;
+
+        tables = AnalysisTables::acquire({config.sample_rate, FftSize, NumMels, config.fmin, config.fmax,
+                                          config.mel_scale, config.periodic_window});
+        window = config.periodic_window ? fft_tables.periodic_window.data() : fft_tables.window.data();
+    }
+
+    void compute_frame(const float* frame, float* out);
+
+    size_t process_samples(const float* input, uint32_t num_samples, std::span<float> out);
+
+    template <typename Visitor>
+    size_t for_each_frame(const float* input, uint32_t num_samples, Visitor&& visit);
+
+    size_t max_frames(uint32_t num_samples) const { return assembler.max_frames(num_samples); }
+    size_t pending_frames() const { return assembler.max_frames(0); }
+    const FeatureExtractorConfig& get_config() const { return config; }
+
+    StaticFeatureExtractor(const StaticFeatureExtractor&) = delete;
+    StaticFeatureExtractor& operator=(const StaticFeatureExtractor&) = delete;
+
+private:
+    static constexpr uint32_t M = FftSize / 2;
+    static constexpr static_features::RealFftTables<FftSize> fft_tables = static_features::make_real_fft_tables<FftSize>();
+
+    float load_frame(const float* frame);
+    void transform();
+    template <uint32_t Half> void radix2_stages();
+    void split_power();
+
+private:
+    FeatureExtractorConfig config;
+    std::shared_ptr<const AnalysisTables> tables;    // shared mel filterbank, same as FeatureExtractor's
+    const float* window = nullptr;                   // one of the constexpr windows
+
+    alignas(64) std::array<float, M> re{};
+    alignas(64) std::array<float, M> im{};
+    alignas(64) std::array<float, num_bins> power{};
+    std::array<float, NumMels> mel_power{};
+    std::array<float, NumMels> frame_scratch{};
+
+    FrameAssembler assembler;
+};
+
+
+using LiveFeatureExtractor = StaticFeatureExtractor<1024, 512, 40>;
+using CnnFeatureExtractor = StaticFeatureExtractor<2048, 512, 128>;
+
+
+/**
+ * Window the frame straight into bit-reversed complex order: even samples are the
+ * real parts, odd samples the imaginary parts.
+ * - returns the abs sum of the raw, unwindowed samples, the silence gate's measure
+ *   (simd::apply_window's return value in FeatureExtractor)
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+float StaticFeatureExtractor<FftSize, Hop, NumMels>::load_frame(const float* frame) {
+    float abs_sum = 0.0f;
+    for (uint32_t n = 0; n < M; ++n) {
+        abs_sum += std::abs(frame[2 * n]) + std::abs(frame[2 * n + 1]);
+        float even = frame[2 * n] * window[2 * n];
+        float odd = frame[2 * n + 1] * window[2 * n + 1];
+
+        uint32_t r = fft_tables.bit_reverse[n];
+        re[r] = even;
+        im[r] = odd;
+    }
+    return abs_sum;
+}
+
+
+/**
+ * In-place radix-2 decimation-in-time FFT over (re, im).
+ * - the first two stages have trivial twiddles (1 and -i) and run fused without
+ *   multiplies, the rest are instantiated per stage so every trip count is a constant
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+void StaticFeatureExtractor<FftSize, Hop, NumMels>::transform() {
+    if constexpr (M == 2) {
+        float r0 = re[0], i0 = im[0];
+        re[0] = r0 + re[1]; im[0] = i0 + im[1];
+        re[1] = r0 - re[1]; im[1] = i0 - im[1];
+        return;
+    } else {
+        for (uint32_t base = 0; base < M; base += 4) {
+            float* r = re.data() + base;
+            float* i = im.data() + base;
+
+            float r0 = r[0] + r[1], i0 = i[0] + i[1];
+            float r1 = r[0] - r[1], i1 = i[0] - i[1];
+            float r2 = r[2] + r[3], i2 = i[2] + i[3];
+            float r3 = r[2] - r[3], i3 = i[2] - i[3];
+
+            r[0] = r0 + r2; i[0] = i0 + i2;
+            r[2] = r0 - r2; i[2] = i0 - i2;
+            r[1] = r1 + i3; i[1] = i1 - r3;     // (r3, i3) * -i = (i3, -r3)
+            r[3] = r1 - i3; i[3] = i1 + r3;
+        }
+        radix2_stages<4>();
+    }
+}
+
+
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+template <uint32_t Half>
+void StaticFeatureExtractor<FftSize, Hop, NumMels>::radix2_stages() {
+    if constexpr (Half < M) {
+        const float* wc = fft_tables.stage_cos.data() + Half - 1;
+        const float* ws = fft_tables.stage_sin.data() + Half - 1;
+
+        for (uint32_t base = 0; base < M; base += 2 * Half) {
+            // indexing the member arrays (not derived pointers) lets the compiler see
+            // that the two halves never overlap, so the loop vectorises
+            for (uint32_t j = 0; j < Half; ++j) {
+                uint32_t a = base + j;
+                uint32_t b = a + Half;
+                float tr = re[b] * wc[j] - im[b] * ws[j];
+                float ti = re[b] * ws[j] + im[b] * wc[j];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+
+        radix2_stages<2 * Half>();
+    }
+}
+
+
+/**
+ * Untangle the N/2 complex bins into the N/2 + 1 real-input bins and square them.
+ * - X[k] = (Z[k] + conj Z[M-k]) / 2 - i W^k (Z[k] - conj Z[M-k]) / 2
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+void StaticFeatureExtractor<FftSize, Hop, NumMels>::split_power() {
+    power[0] = (re[0] + im[0]) * (re[0] + im[0]);
+    power[M] = (re[0] - im[0]) * (re[0] - im[0]);
+
+    for (uint32_t k = 1; k < M; ++k) {
+        float a = re[k], b = im[k];
+        float c = re[M - k], d = im[M - k];
+
+        float even_r = 0.5f * (a + c);
+        float even_i = 0.5f * (b - d);
+        float odd_r = 0.5f * (b + d);
+        float odd_i = -0.5f * (a - c);
+
+        float wc = fft_tables.split_cos[k];
+        float ws = fft_tables.split_sin[k];
+        float xr = even_r + wc * odd_r - ws * odd_i;
+        float xi = even_i + wc * odd_i + ws * odd_r;
+        power[k] = xr * xr + xi * xi;
+    }
+}
+
+
+/**
+ * One log-mel frame of FftSize samples into NumMels values, allocation-free.
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+void StaticFeatureExtractor<FftSize, Hop, NumMels>::compute_frame(const float* frame, float* out) {
+    if (load_frame(frame) < config.silence_threshold) {
+        std::fill(out, out + NumMels, -config.top_db);
+        return;
+    }
+
+    transform();
+    split_power();
+    tables->mel_filterbank.project(power.data(), mel_power.data());
+
+    float max_db = simd::power_to_db(mel_power.data(), NumMels, config.eps, out);
+
+    float min_db = max_db - config.top_db;
+    for (uint32_t m = 0; m < NumMels; ++m)
+        out[m] = std::max(out[m], min_db);
+}
+
+
+/**
+ * Same contract as FeatureExtractor::process_samples(input, num_samples, out).
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+size_t StaticFeatureExtractor<FftSize, Hop, NumMels>::process_samples(const float* input, uint32_t num_samples, std::span<float> out) {
+    return assembler.fill_frames(input, num_samples, out.size() / NumMels, [&](const float* frame, size_t row) {
+        compute_frame(frame, out.data() + row * NumMels);
+    });
+}
+
+
+/**
+ * Same contract as FeatureExtractor::for_each_frame.
+ */
+template <uint32_t FftSize, uint32_t Hop, uint32_t NumMels>
+template <typename Visitor>
+size_t StaticFeatureExtractor<FftSize, Hop, NumMels>::for_each_frame(const float* input, uint32_t num_samples, Visitor&& visit) {
+    return assembler.for_each_frame(input, num_samples, [&](const float* frame, size_t) {
+        compute_frame(frame, frame_scratch.data());
+        visit(std::span<const float>(frame_scratch));
+    });
+}
+
+#endif // H_STATIC_FEATURE_EXTRACTOR
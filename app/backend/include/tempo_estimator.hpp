@@ -0,0 +1,73 @@
+#ifndef H_TEMPO_ESTIMATOR
+#define H_TEMPO_ESTIMATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "fft_backend.hpp"
+
+
+/**
+ * librosa.feature.tempo parameters (also what librosa.beat.beat_track reports).
+ */
+struct TempoConfig {
+    uint32_t sample_rate = 22050;
+    uint32_t hop_length = 512;      // of the onset envelope
+
+    float ac_seconds = 8.0f;        // autocorrelation window
+    float start_bpm = 120.0f;       // centre of the log-normal tempo prior
+    float std_bpm = 1.0f;           // its width in octaves
+    float max_bpm = 320.0f;
+};
+
+
+/**
+ * Global tempo of an onset-strength envelope, fed one value per frame.
+ *
+ * - tempogram as librosa.feature.tempogram: for every frame, the autocorrelation of
+ *   the periodic-Hann-windowed envelope over `ac_seconds` around it, normalised by
+ *   its lag-0 value; the envelope is zero-ramped at both ends ("linear_ramp")
+ * - the columns are summed as they complete, so only one window of envelope is kept
+ * - finish() closes the envelope, averages the columns, weights each lag by the
+ *   log-normal prior and returns the BPM of the best lag, 60 * sample_rate /
+ *   (hop_length * lag); estimate() does the same over the columns complete so far
+ * - autocorrelations run as two real FFTs (power spectrum, then transform of it)
+ */
+class TempoEstimator {
+public:
+    explicit TempoEstimator(const TempoConfig& config = {});
+
+    void push(float onset);
+    float estimate() const;
+    float finish();
+    void reset();
+
+    uint32_t window_frames() const;
+    const TempoConfig& get_config() const;
+
+private:
+    void append(float value);
+    void add_column();
+
+private:
+    TempoConfig config;
+    uint32_t window_length = 0;
+    uint32_t half = 0;
+
+    std::vector<float> ac_window;
+    std::unique_ptr<FftBackend> fft;
+    std::vector<float> spectrum;
+
+    // last window_length values of the padded envelope, ring by position
+    std::vector<float> envelope;
+    uint64_t padded_length = 0;
+    uint64_t onsets_pushed = 0;
+    uint64_t columns = 0;
+    float last_onset = 0.0f;
+
+    std::vector<double> tempogram_sum;
+};
+
+#endif // H_TEMPO_ESTIMATOR
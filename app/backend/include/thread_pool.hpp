@@ -0,0 +1,46 @@
+#ifndef H_THREAD_POOL
+#define H_THREAD_POOL
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads running queued jobs in FIFO order.
+ *
+ * - sized once at construction, threads live until the pool is destroyed
+ * - used for feature extraction off the capture threads, never on a real-time thread
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    void submit(std::function<void()> job);
+    void wait_idle();
+    size_t size() const;
+
+    static size_t default_thread_count();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    void worker_loop();
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+
+    std::mutex mutex;
+    std::condition_variable job_available;
+    std::condition_variable idle;
+    size_t active_jobs = 0;
+    bool shutting_down = false;
+};
+
+#endif // H_THREAD_POOL
@@ -0,0 +1,78 @@
+#ifndef H_WAKE_EVENT
+#define H_WAKE_EVENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if !defined(__linux__)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/**
+ * One-shot style wake-up from a real-time producer to a blocked consumer.
+ *
+ * - notify() is wait-free: it only touches the kernel (futex wake on Linux) when a
+ *   waiter is actually registered, otherwise it is a single atomic load
+ * - wait() sleeps until a caller-supplied predicate holds, the timeout expires or
+ *   interrupt() is called
+ */
+class WakeEvent {
+public:
+    static constexpr std::chrono::nanoseconds WAIT_FOREVER = std::chrono::nanoseconds::max();
+
+    void notify();
+    void interrupt();
+    void clear_interrupt();
+    bool interrupted() const;
+
+    /**
+     * Block until `ready()` returns true.
+     * - returns the final value of `ready()`, so false means timeout or interrupt
+     */
+    template <typename Pred>
+    bool wait(Pred ready, std::chrono::nanoseconds timeout = WAIT_FOREVER) {
+        if (ready()) return true;
+
+        using clock = std::chrono::steady_clock;
+        const bool forever = timeout == WAIT_FOREVER;
+        const clock::time_point deadline = forever ? clock::time_point::max() : clock::now() + timeout;
+
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+
+        bool result = false;
+        while (true) {
+            uint32_t seen = epoch.load(std::memory_order_acquire);
+
+            // re-check after registering, the producer may have published in between
+            if ((result = ready()) || interrupted()) break;
+
+            std::chrono::nanoseconds remaining = WAIT_FOREVER;
+            if (!forever) {
+                remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - clock::now());
+                if (remaining.count() <= 0) break;
+            }
+
+            sleep_while_epoch(seen, remaining);
+        }
+
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return result;
+    }
+
+private:
+    void sleep_while_epoch(uint32_t seen, std::chrono::nanoseconds timeout);
+
+private:
+    alignas(64) std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> waiters{0};
+    std::atomic<bool> stop_requested{false};
+
+#if !defined(__linux__)
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+#endif
+};
+
+#endif // H_WAKE_EVENT
@@ -0,0 +1,41 @@
+/*
+ *  4-wide build of kiss_fft / kiss_fftr.
+ *
+ *  With USE_SIMD kiss_fft_scalar is an __m128, so one transform runs four
+ *  independent real FFTs in lockstep: sample n of lane j is timedata[n][j].
+ *  The scalar build (kiss_fft.c, kiss_fftr.c) is compiled as usual, so every
+ *  public symbol of this translation unit gets a _simd4 name and the config
+ *  buffers come from the 16-byte aligned KISS_FFT_MALLOC (_mm_malloc).
+ *
+ *  The prototypes are in batch_fft.cpp; this file is empty without SSE.
+ */
+
+#if defined(__SSE__) || defined(_M_X64)
+
+#define USE_SIMD
+
+#define kiss_fft_alloc          kiss_fft_simd4_alloc
+#define kiss_fft                kiss_fft_simd4
+#define kiss_fft_stride         kiss_fft_simd4_stride
+#define kiss_fft_cleanup        kiss_fft_simd4_cleanup
+#define kiss_fft_next_fast_size kiss_fft_simd4_next_fast_size
+#define kiss_fftr_alloc         kiss_fftr_simd4_alloc
+#define kiss_fftr               kiss_fftr_simd4
+#define kiss_fftri              kiss_fftri_simd4
+
+#include "kiss_fft.c"
+#include "kiss_fftr.c"
+
+#ifdef __cplusplus
+extern "C"
+#endif
+void kiss_fftr_simd4_free(void* cfg)
+{
+    KISS_FFT_FREE(cfg);
+}
+
+#else
+
+typedef int kiss_fft_simd4_unavailable;
+
+#endif
@@ -0,0 +1,46 @@
+#include <cmath>
+
+#include "analysis_tables.hpp"
+#include "shared_table_cache.hpp"
+
+
+static SharedTableCache<AnalysisTablesKey, AnalysisTables>& tables_cache() {
+    static SharedTableCache<AnalysisTablesKey, AnalysisTables> cache;
+    return cache;
+}
+
+
+static std::shared_ptr<const AnalysisTables> build_tables(const AnalysisTablesKey& key) {
+    auto tables = std::make_shared<AnalysisTables>();
+    tables->key = key;
+
+    const uint32_t period = key.periodic_window ? key.fft_size : key.fft_size - 1;
+    tables->window.resize(key.fft_size);
+    for (uint32_t i = 0; i < key.fft_size; ++i) {
+        tables->window[i] = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / period));
+    }
+
+    tables->mel_filterbank = build_mel_filterbank(key.sample_rate, key.fft_size, key.num_mels, key.fmin, key.fmax, key.mel_scale);
+
+    tables->bin_frequencies.resize(key.fft_size / 2 + 1);
+    for (uint32_t k = 0; k < tables->bin_frequencies.size(); ++k) {
+        tables->bin_frequencies[k] = float(double(k) * key.sample_rate / key.fft_size);
+    }
+    return tables;
+}
+
+
+/**
+ * Tables for `key`, built on first use and shared while anyone holds them.
+ */
+std::shared_ptr<const AnalysisTables> AnalysisTables::acquire(const AnalysisTablesKey& key) {
+    return tables_cache().acquire(key, [&] { return build_tables(key); });
+}
+
+
+/**
+ * Distinct table sets currently alive in the process.
+ */
+size_t AnalysisTables::live_count() {
+    return tables_cache().live_count();
+}
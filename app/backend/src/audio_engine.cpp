@@ -1,78 +1,241 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
-#include <cstring>
+#include <optional>
 
 #include "miniaudio.h"
 #include "audio_engine.hpp"
+#include "device_registry.hpp"
+#include "simd_kernels.hpp"
 
 
-AudioEngine::AudioEngine(ma_uint32 capture_device_index) : device_index(capture_device_index) {}
+AudioEngine::AudioEngine(ma_uint32 capture_device_index, const AudioEngineConfig& config)
+    : AudioEngine(CaptureSourceConfig::device(capture_device_index), config) {}
+
+
+AudioEngine::AudioEngine(const CaptureSourceConfig& source_config, const AudioEngineConfig& config)
+    : source(source_config), engine_config(config) {}
+
+
+double NegotiatedFormat::period_ms() const {
+    return internal_sample_rate ? 1000.0 * period_frames / internal_sample_rate : 0.0;
+}
+
+
+double NegotiatedFormat::latency_ms() const {
+    return period_ms() * periods;
+}
 
 
 /**
  * Initializes the audio engine.
  * 
  * What is initialized:
- *  - miniaudio context for device discovery
  *  - ring buffer for decoupling capture from processing
- *  - audio device for reading mono float32 samples
+ *  - device sources: the audio device, opened on the shared DeviceRegistry context
+ *  - file/synthetic sources: the decoder or signal generator read by the pump thread
  */
 AudioEngine::InitResult AudioEngine::init() {
-    // initialize audio context, for querying available devices and backend state
-    if (ma_context_init(nullptr, 0, nullptr, &context) != MA_SUCCESS) {
-        std::cerr << "failed to initialize audio context \n";
-        return InitResult::context_failure;
-    }
-    context_initialized = true;
-
     // initialize a ring buffer to decouple real-time audio capture from downstream processing
-    ma_result rb_res = ma_pcm_rb_init(ma_format_f32, CHANNELS, SAMPLE_RATE * RECORD_SEC, nullptr, nullptr, &ring_buffer);
-    if (rb_res != MA_SUCCESS) {
-        std::cerr << "ma_pcm_rb_init failed: " << ma_result_description(rb_res) << "\n";
+    if (!ring_buffer.init(engine_config.ring_frames, engine_config.max_view_frames)) {
+        std::cerr << "failed to allocate capture ring buffer\n";
         return InitResult::ring_buffer_failure;
     }
-    ring_buffer_initialized = true;
+    telemetry.set_ring_capacity(ring_buffer.capacity());
 
-    // query all detected audio devices, for selecting the capture device by index
-    ma_device_info* capture_infos;
-    ma_uint32 capture_count;
-    ma_context_get_devices(&context, nullptr, nullptr, &capture_infos, &capture_count);
+    if (!init_channel_mixing()) {
+        return InitResult::config_failure;
+    }
+
+    InitResult result = source.kind == CaptureSourceKind::device ? init_device() : init_pull_source();
+    if (result != InitResult::success) return result;
+
+    init_result = InitResult::success;
+    return init_result;
+}
+
+
+/**
+ * Prepare the multichannel path: downmix weights, scratch blocks and per-channel rings.
+ * - everything the audio thread touches is allocated here, never in the callback
+ * - returns false on an invalid channel/weight configuration
+ */
+bool AudioEngine::init_channel_mixing() {
+    const ma_uint32 channels = engine_config.channels;
+    if (channels == 0) return false;
+
+    if (engine_config.channel_weights.empty()) {
+        mix_weights.assign(channels, 1.0f / channels);
+    } else if (engine_config.channel_weights.size() == channels) {
+        mix_weights = engine_config.channel_weights;
+    } else {
+        std::cerr << "expected " << channels << " channel weights, got " << engine_config.channel_weights.size() << "\n";
+        return false;
+    }
+
+    mix_scratch.assign(MIX_BLOCK_FRAMES, 0.0f);
+    split_scratch.assign(size_t(MIX_BLOCK_FRAMES) * engine_config.split_channels.size(), 0.0f);
+    split_outputs.assign(channels, nullptr);
+    channel_rings.clear();
+
+    for (ma_uint32 channel : engine_config.split_channels) {
+        if (channel >= channels || split_outputs[channel]) {
+            std::cerr << "invalid or duplicate split channel: " << channel << "\n";
+            return false;
+        }
+
+        ChannelRing entry;
+        entry.channel = channel;
+        entry.ring = std::make_unique<SpscRing>();
+        if (!entry.ring->init(engine_config.ring_frames, engine_config.max_view_frames)) return false;
+
+        split_outputs[channel] = split_scratch.data() + channel_rings.size() * MIX_BLOCK_FRAMES;
+        channel_rings.push_back(std::move(entry));
+    }
 
-    if (device_index >= capture_count) {
-        std::cerr << "Invalid capture device index: " << device_index << "\n";
+    mix_passthrough = channels == 1 && mix_weights[0] == 1.0f && channel_rings.empty();
+    return true;
+}
+
+
+/**
+ * Open the live capture device selected by `source.device_id` or `source.device_index`.
+ */
+AudioEngine::InitResult AudioEngine::init_device() {
+    // the shared context and cached device list live in the registry, so opening a
+    // device does not re-probe the backends
+    DeviceRegistry& registry = DeviceRegistry::instance();
+    ma_context* context = registry.get_context();
+    if (!context) {
+        return InitResult::context_failure;
+    }
+
+    std::optional<CaptureDeviceInfo> device_info = source.device_id.empty()
+        ? registry.device_at(source.device_index)
+        : registry.find_device(source.device_id);
+
+    if (!device_info) {
+        if (source.device_id.empty()) {
+            std::cerr << "Invalid capture device index: " << source.device_index << "\n";
+        } else {
+            std::cerr << "Unknown capture device: " << source.device_id << "\n";
+        }
         return InitResult::device_failure;
     }
 
-    // device settings (mono, float32)
+    // device settings (float32, configured rate and channel count)
     ma_device_config config = ma_device_config_init(ma_device_type_capture);
     config.capture.format = ma_format_f32;
-    config.capture.channels = CHANNELS;
-    config.capture.pDeviceID = &capture_infos[device_index].id;
-    config.sampleRate = SAMPLE_RATE;
+    config.capture.channels = engine_config.channels;
+    config.capture.pDeviceID = &device_info->id;
+    config.sampleRate = engine_config.sample_rate;
+
+    // period negotiation, 0 leaves the choice to the backend within the performance profile
+    config.periodSizeInFrames = engine_config.period_frames;
+    config.periods = engine_config.periods;
+    config.performanceProfile = engine_config.performance_profile;
 
     // callback is called on real-time audio thread, use pUserData to pass the engine instance to the callback
     config.dataCallback = data_callback;
     config.pUserData = this;
 
     // create the device based on the configured parameters
-    ma_result dev_res = ma_device_init(&context, &config, &audio_device);
+    ma_result dev_res = ma_device_init(context, &config, &audio_device);
     if (dev_res != MA_SUCCESS) {
         std::cerr << "ma_device_init failed: " << ma_result_description(dev_res) << "\n";
         return InitResult::device_failure;
     }
     device_initialized = true;
 
-    init_result = InitResult::success;
-    return init_result;
+    // report what the backend actually settled on
+    negotiated.sample_rate = audio_device.sampleRate;
+    negotiated.channels = audio_device.capture.channels;
+    negotiated.internal_sample_rate = audio_device.capture.internalSampleRate;
+    negotiated.internal_channels = audio_device.capture.internalChannels;
+    negotiated.period_frames = audio_device.capture.internalPeriodSizeInFrames;
+    negotiated.periods = audio_device.capture.internalPeriods;
+
+    return InitResult::success;
+}
+
+
+/**
+ * Open a file decoder or signal generator as a miniaudio data source.
+ * - every source is converted to the engine format (float32 at the configured rate and channel count)
+ */
+AudioEngine::InitResult AudioEngine::init_pull_source() {
+    ma_result res = MA_SUCCESS;
+
+    if (source.kind == CaptureSourceKind::file) {
+        // the decoder handles WAV/MP3/FLAC and resamples/downmixes to the engine format
+        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, engine_config.channels, engine_config.sample_rate);
+        res = ma_decoder_init_file(source.file_path.c_str(), &config, &decoder);
+        if (res != MA_SUCCESS) {
+            std::cerr << "ma_decoder_init_file failed for " << source.file_path << ": " << ma_result_description(res) << "\n";
+            return InitResult::source_failure;
+        }
+        decoder_initialized = true;
+        pull_source = &decoder;
+
+    } else if (source.waveform == SyntheticWaveform::white_noise) {
+        ma_noise_config config = ma_noise_config_init(ma_format_f32, engine_config.channels, ma_noise_type_white, 0, source.amplitude);
+        res = ma_noise_init(&config, nullptr, &noise);
+        if (res != MA_SUCCESS) {
+            std::cerr << "ma_noise_init failed: " << ma_result_description(res) << "\n";
+            return InitResult::source_failure;
+        }
+        noise_initialized = true;
+        pull_source = &noise;
+
+    } else {
+        ma_waveform_type type = ma_waveform_type_sine;
+        double amplitude = source.amplitude;
+        switch (source.waveform) {
+            case SyntheticWaveform::square: type = ma_waveform_type_square; break;
+            case SyntheticWaveform::triangle: type = ma_waveform_type_triangle; break;
+            case SyntheticWaveform::sawtooth: type = ma_waveform_type_sawtooth; break;
+            case SyntheticWaveform::silence: amplitude = 0.0; break;
+            default: break;
+        }
+
+        ma_waveform_config config = ma_waveform_config_init(ma_format_f32, engine_config.channels, engine_config.sample_rate, type, amplitude, source.frequency);
+        res = ma_waveform_init(&config, &waveform);
+        if (res != MA_SUCCESS) {
+            std::cerr << "ma_waveform_init failed: " << ma_result_description(res) << "\n";
+            return InitResult::source_failure;
+        }
+        waveform_initialized = true;
+        pull_source = &waveform;
+    }
+
+    ma_data_source_set_looping(pull_source, source.loop ? MA_TRUE : MA_FALSE);
+
+    // the pump thread is the "device" here, it delivers one period per block
+    negotiated.sample_rate = engine_config.sample_rate;
+    negotiated.channels = engine_config.channels;
+    negotiated.internal_sample_rate = engine_config.sample_rate;
+    negotiated.internal_channels = engine_config.channels;
+    negotiated.period_frames = engine_config.period_frames ? engine_config.period_frames : engine_config.sample_rate / 100;
+    negotiated.periods = 1;
+
+    return InitResult::success;
 }
 
 
 /**
  * Start capturing audio.
- * - invokes the audio callback on a real-time audio thread
+ * - device sources: invokes the audio callback on a real-time audio thread
+ * - file/synthetic sources: starts the pump thread
  */
 void AudioEngine::start() {
-    if (init_result == InitResult::success) {
+    if (init_result != InitResult::success) return;
+
+    data_ready.clear_interrupt();
+
+    if (source.kind == CaptureSourceKind::device) {
         ma_device_start(&audio_device);
+    } else if (!pump_running.exchange(true)) {
+        pump_thread = std::thread(&AudioEngine::pump_source, this);
     }
 }
 
@@ -82,7 +245,94 @@ void AudioEngine::start() {
  * - no more callbacks once executed
  */
 void AudioEngine::stop() {
-    ma_device_stop(&audio_device);
+    if (device_initialized) {
+        ma_device_stop(&audio_device);
+    }
+
+    pump_running.store(false);
+    if (pump_thread.joinable()) {
+        pump_thread.join();
+    }
+
+    // release a consumer blocked in wait_for_frames(), no more data is coming
+    data_ready.interrupt();
+}
+
+
+/**
+ * True once a file or finite synthetic source has delivered its last frame.
+ * - frames may still be buffered, keep reading until read_chunk() fails
+ */
+bool AudioEngine::is_source_exhausted() const {
+    return source_exhausted.load(std::memory_order_acquire);
+}
+
+
+/**
+ * Frames currently buffered and not yet consumed.
+ */
+size_t AudioEngine::available_frames() const {
+    return ring_buffer.available_read();
+}
+
+
+/**
+ * Pump thread for file and synthetic sources.
+ * - reads one period (`negotiated.period_frames`) at a time from the data source
+ * - real-time pacing sleeps one period between blocks and drops frames on overrun,
+ *   exactly like a device would
+ * - as-fast-as-possible pacing never drops: it waits for the consumer to free ring space
+ */
+void AudioEngine::pump_source() {
+    using clock = std::chrono::steady_clock;
+
+    const ma_uint32 period_frames = negotiated.period_frames;
+    std::vector<float> block(size_t(period_frames) * engine_config.channels);
+    const auto period = std::chrono::nanoseconds(uint64_t(period_frames) * 1000000000ull / engine_config.sample_rate);
+    const bool real_time = source.pacing == SourcePacing::real_time;
+
+    uint64_t delivered = 0;
+    clock::time_point next_block = clock::now();
+
+    while (pump_running.load(std::memory_order_relaxed)) {
+        ma_uint64 wanted = period_frames;
+        if (source.duration_frames > 0) {
+            wanted = std::min<ma_uint64>(wanted, source.duration_frames - delivered);
+        }
+
+        ma_uint64 frames_read = 0;
+        if (wanted > 0) {
+            ma_data_source_read_pcm_frames(pull_source, block.data(), wanted, &frames_read);
+        }
+        if (frames_read == 0) break;
+
+        auto started = clock::now();
+        ma_uint32 written = ma_uint32(frames_read);
+        if (real_time) {
+            written = write_frames(block.data(), ma_uint32(frames_read));
+        } else {
+            write_frames_lossless(block.data(), ma_uint32(frames_read));
+        }
+        auto elapsed = clock::now() - started;
+
+        telemetry.record_callback(
+            written,
+            frames_read - written,
+            ring_buffer.available_read(),
+            uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            frames_read * 1000000000ull / engine_config.sample_rate
+        );
+        delivered += frames_read;
+
+        if (real_time) {
+            next_block += period;
+            std::this_thread::sleep_until(next_block);
+        }
+    }
+
+    source_exhausted.store(true, std::memory_order_release);
+    data_ready.interrupt();
+    if (chunk_listener) chunk_listener->notify();
 }
 
 
@@ -90,14 +340,37 @@ void AudioEngine::stop() {
  * Retrieves a pointer to the ring buffer
  * - used for diagnostics or to extract straight from the rb, but prefer reading chunks
  */
-ma_pcm_rb *AudioEngine::get_ring_buffer() {
+SpscRing *AudioEngine::get_ring_buffer() {
     return &ring_buffer;
 }
 
 
+/**
+ * Capture path counters: dropped frames, ring fill level, callback timing.
+ * - safe to call from any thread while capture is running
+ */
+CaptureStats AudioEngine::get_stats() const {
+    return telemetry.snapshot();
+}
+
+
+const AudioEngineConfig& AudioEngine::get_config() const {
+    return engine_config;
+}
+
+
+/**
+ * Sample rate, channels, period size and latency actually negotiated by init().
+ */
+const NegotiatedFormat& AudioEngine::get_negotiated_format() const {
+    return negotiated;
+}
+
+
 /**
  * Audio callback invoked on a real-time audio thread.
  * - copy captured audio into the ring buffer
+ * - time the callback against the duration of the frames it delivered
  */
 void AudioEngine::data_callback(ma_device *device, void *output, const void *input, ma_uint32 frame_count) {
     // capture only, explicitly suppress unused output variable warnings
@@ -107,62 +380,343 @@ void AudioEngine::data_callback(ma_device *device, void *output, const void *inp
     // retrieve the audio engine associated with the device on this thread
     AudioEngine *engine = static_cast<AudioEngine*>(device->pUserData);
 
-    ma_uint32 frames = frame_count;
-    float *dest = nullptr;
+    auto started = std::chrono::steady_clock::now();
+    ma_uint32 written = engine->write_frames(static_cast<const float*>(input), frame_count);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    engine->telemetry.record_callback(
+        written,
+        frame_count - written,
+        engine->ring_buffer.available_read(),
+        uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        uint64_t(frame_count) * 1000000000ull / engine->engine_config.sample_rate
+    );
+}
+
+
+/**
+ * Producer side of the capture path, runs on the real-time audio thread.
+ * - writes as many frames as the ring buffer has room for
+ * - frames that do not fit are dropped and recorded as a discontinuity at the
+ *   current stream position, so the consumer can see exactly where the gap is
+ * - returns the number of frames written
+ */
+ma_uint32 AudioEngine::write_frames(const float* input, ma_uint32 frame_count) {
+    mark_stream_start(frame_count);
+
+    size_t written = 0;
+    for (ma_uint32 offset = 0; offset < frame_count; offset += MIX_BLOCK_FRAMES) {
+        ma_uint32 block_frames = std::min(MIX_BLOCK_FRAMES, frame_count - offset);
+        const float* mono = mix_block(input + size_t(offset) * engine_config.channels, block_frames);
+
+        // once the ring is full, drop the rest of the callback so the gap sits at one position
+        if (written == offset) {
+            written += ring_buffer.write(mono, block_frames);
+        }
+    }
+
+    notify_consumer();
+
+    uint64_t lost = frame_count - written + unreported_frames_lost;
+    if (lost == 0) return ma_uint32(written);
 
-    // write frames to the ring buffer based on the amount of space it currently has available
-    if (ma_pcm_rb_acquire_write(&engine->ring_buffer, &frames, (void **)&dest) == MA_SUCCESS && frames > 0) {
-        memcpy(dest, input, frames * sizeof(float));
-        ma_pcm_rb_commit_write(&engine->ring_buffer, frames);
+    Discontinuity gap;
+    gap.sequence = gaps_recorded + 1;
+    gap.frame_position = ring_buffer.write_position();
+    gap.frames_lost = lost;
+
+    // if the consumer has fallen so far behind that the gap queue is full, fold the
+    // loss into the next record instead of blocking the audio thread
+    if (pending_gaps.push(gap)) {
+        gaps_recorded = gap.sequence;
+        unreported_frames_lost = 0;
+    } else {
+        unreported_frames_lost = lost;
     }
+
+    return ma_uint32(written);
+}
+
+
+/**
+ * Producer side for as-fast-as-possible sources.
+ * - blocks until every frame fits, so nothing is ever dropped
+ */
+void AudioEngine::write_frames_lossless(const float* input, ma_uint32 frame_count) {
+    mark_stream_start(frame_count);
+
+    for (ma_uint32 offset = 0; offset < frame_count; offset += MIX_BLOCK_FRAMES) {
+        ma_uint32 block_frames = std::min(MIX_BLOCK_FRAMES, frame_count - offset);
+        const float* mono = mix_block(input + size_t(offset) * engine_config.channels, block_frames);
+        size_t written = 0;
+
+        while (true) {
+            written += ring_buffer.write(mono + written, block_frames - written);
+            notify_consumer();
+
+            if (written == block_frames || !pump_running.load(std::memory_order_relaxed)) break;
+
+            // ring is full, give the consumer time to drain it
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+
+/**
+ * Turn one block of interleaved frames into the mono analysis signal.
+ * - single-channel input with unit weight is passed through untouched
+ * - multichannel input is downmixed with the configured channel weights, and the
+ *   channels that have their own ring are split out of the same block
+ * - channel rings never block the producer, they drop when nobody drains them
+ * - `frame_count` must not exceed MIX_BLOCK_FRAMES
+ */
+const float* AudioEngine::mix_block(const float* input, ma_uint32 frame_count) {
+    if (mix_passthrough) return input;
+
+    simd::downmix(input, frame_count, engine_config.channels, mix_weights.data(), mix_scratch.data());
+
+    if (!channel_rings.empty()) {
+        simd::deinterleave(input, frame_count, engine_config.channels, split_outputs.data());
+        for (size_t i = 0; i < channel_rings.size(); ++i) {
+            channel_rings[i].ring->write(split_scratch.data() + i * MIX_BLOCK_FRAMES, frame_count);
+        }
+    }
+
+    return mix_scratch.data();
+}
+
+
+/**
+ * Wake a blocked consumer, but only once it has enough buffered to work with.
+ * - the fence pairs with the one in wait_for_frames(): either we see the consumer's
+ *   threshold or it sees our head, so a wake-up is never lost between the two
+ */
+void AudioEngine::notify_consumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_t available = ring_buffer.available_read();
+    if (available >= wake_threshold.load(std::memory_order_relaxed)) {
+        data_ready.notify();
+    }
+    if (chunk_listener && available >= chunk_listener_threshold) {
+        chunk_listener->notify();
+    }
+}
+
+
+/**
+ * Remember when the first frame of the stream was captured (producer side, once).
+ * - the first block arrives when its last frame is captured, so back off by its duration
+ */
+void AudioEngine::mark_stream_start(ma_uint32 frame_count) {
+    if (stream_start_ns.load(std::memory_order_relaxed) != 0) return;
+
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+    int64_t block_ns = int64_t(uint64_t(frame_count) * 1000000000ull / engine_config.sample_rate);
+    stream_start_ns.store(std::max<int64_t>(now - block_ns, 1), std::memory_order_release);
+}
+
+
+/**
+ * Also wake `listener` whenever at least `frames` frames are buffered.
+ * - lets one consumer thread sleep on several engines at once
+ * - only call before start(), the audio thread reads it without synchronization
+ */
+void AudioEngine::set_chunk_listener(WakeEvent* listener, ma_uint32 frames) {
+    chunk_listener = listener;
+    chunk_listener_threshold = frames;
+}
+
+
+/**
+ * steady_clock time at which stream frame 0 was captured, empty until capture starts.
+ * - frame N of the stream was captured at start + N / sample_rate, which lets several
+ *   engines be put on one timeline
+ */
+std::optional<std::chrono::steady_clock::time_point> AudioEngine::get_stream_start_time() const {
+    int64_t ns = stream_start_ns.load(std::memory_order_acquire);
+    if (ns == 0) return std::nullopt;
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns));
+}
+
+
+/**
+ * Attach metadata to the chunk starting at the current read position.
+ * - every pending gap that falls before the end of the chunk is reported with it
+ * - the result is kept until the chunk is consumed, so repeated acquire_chunk() calls
+ *   on the same chunk report the same gaps
+ */
+void AudioEngine::collect_chunk_info(ma_uint32 frames, ChunkInfo* info) {
+    if (!current_chunk_valid) {
+        current_chunk = ChunkInfo{};
+        current_chunk.sequence = chunk_sequence;
+        current_chunk.first_frame = ring_buffer.read_position();
+        current_chunk_valid = true;
+    }
+
+    const Discontinuity* gap = pending_gaps.front();
+    while (gap && gap->frame_position < current_chunk.first_frame + frames) {
+        current_chunk.discontinuity = true;
+        current_chunk.frames_lost += gap->frames_lost;
+        last_gap_sequence = gap->sequence;
+
+        pending_gaps.pop();
+        gap = pending_gaps.front();
+    }
+    current_chunk.gap_sequence = last_gap_sequence;
+
+    if (info) *info = current_chunk;
 }
 
 
 /**
  * Read a fixed-size audio chunk from the ring buffer.
- * - returns true only when exactly `frames` samples are available
- * - partial reads are discarded to preserve stable processing windows
+ * - returns true only when `frames` frames are available
+ * - nothing is consumed otherwise: partial data stays buffered until the chunk is
+ *   complete, so polling early never loses audio
+ * - `info` (optional) reports the chunk sequence number and any capture gaps
  */
-bool AudioEngine::read_chunk(float* out, ma_uint32 frames)
+bool AudioEngine::read_chunk(float* out, ma_uint32 frames, ChunkInfo* info)
 {
-    ma_uint32 available = frames;
-    float* src = nullptr;
+    size_t samples = frames;
+    if (ring_buffer.available_read() < samples) return false;
 
-    ma_result res = ma_pcm_rb_acquire_read(&ring_buffer, &available, (void**)&src);
+    collect_chunk_info(frames, info);
+    ring_buffer.read(out, samples);
+    ++chunk_sequence;
+    current_chunk_valid = false;
 
-    if (res != MA_SUCCESS || available < frames) {
-        if (res == MA_SUCCESS && available > 0) {
-            ma_pcm_rb_commit_read(&ring_buffer, available);
-        }
-        return false;
+    return true;
+}
+
+
+/**
+ * Borrow the next `frames` frames straight out of the ring buffer (zero-copy).
+ * - returns an empty span until a full chunk is buffered, nothing is consumed in that case
+ * - `frames` must not exceed `AudioEngineConfig::max_view_frames`
+ * - the view stays valid until release_chunk() hands the frames back to the capture thread
+ */
+std::span<const float> AudioEngine::acquire_chunk(ma_uint32 frames, ChunkInfo* info) {
+    std::span<const float> view = ring_buffer.read_view(frames);
+    if (!view.empty()) collect_chunk_info(frames, info);
+    return view;
+}
+
+
+/**
+ * Metadata of the chunk starting at the current read position, without waiting for
+ * its frames.
+ * - labels the end of an exhausted source, which may be shorter than a chunk or empty
+ */
+ChunkInfo AudioEngine::next_chunk_info() {
+    ChunkInfo info;
+    collect_chunk_info(0, &info);
+    return info;
+}
+
+
+/**
+ * Release a chunk previously borrowed with acquire_chunk().
+ */
+void AudioEngine::release_chunk(ma_uint32 frames) {
+    ring_buffer.consume(frames);
+    ++chunk_sequence;
+    current_chunk_valid = false;
+}
+
+
+/**
+ * Ring holding one raw input channel, nullptr unless the channel is in `split_channels`.
+ */
+SpscRing* AudioEngine::channel_ring(ma_uint32 channel) {
+    for (ChannelRing& entry : channel_rings) {
+        if (entry.channel == channel) return entry.ring.get();
     }
+    return nullptr;
+}
+
 
-    memcpy(out, src, frames * sizeof(float));
-    ma_pcm_rb_commit_read(&ring_buffer, frames);
+/**
+ * Copy a chunk of one raw input channel (before downmix).
+ * - only for channels listed in AudioEngineConfig::split_channels
+ * - like read_chunk(), nothing is consumed until a full chunk is available
+ */
+bool AudioEngine::read_channel_chunk(ma_uint32 channel, float* out, ma_uint32 frames) {
+    SpscRing* ring = channel_ring(channel);
+    if (!ring || ring->available_read() < frames) return false;
 
+    ring->read(out, frames);
     return true;
 }
 
 
+/**
+ * Zero-copy view of a chunk of one raw input channel, see acquire_chunk().
+ */
+std::span<const float> AudioEngine::acquire_channel_chunk(ma_uint32 channel, ma_uint32 frames) {
+    SpscRing* ring = channel_ring(channel);
+    if (!ring) return {};
+    return ring->read_view(frames);
+}
+
+
+void AudioEngine::release_channel_chunk(ma_uint32 channel, ma_uint32 frames) {
+    SpscRing* ring = channel_ring(channel);
+    if (ring) ring->consume(frames);
+}
+
+
+/**
+ * Block the consumer until at least `frames` frames are buffered.
+ * - the audio thread wakes us once that threshold is crossed, there is no polling
+ * - returns false on timeout or when capture is stopped before enough frames arrive
+ */
+bool AudioEngine::wait_for_frames(ma_uint32 frames, std::chrono::nanoseconds timeout) {
+    size_t samples = frames;
+    wake_threshold.store(samples, std::memory_order_relaxed);
+
+    // store-load barrier: the head check below must not move ahead of the threshold
+    // store, see notify_consumer()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool ready = data_ready.wait([&] { return ring_buffer.available_read() >= samples; }, timeout);
+
+    wake_threshold.store(SIZE_MAX, std::memory_order_relaxed);
+    return ready;
+}
+
+
+/**
+ * Blocking variant of read_chunk().
+ * - returns false on timeout or stop, partial data stays buffered
+ */
+bool AudioEngine::read_chunk_blocking(float* out, ma_uint32 frames, std::chrono::nanoseconds timeout, ChunkInfo* info) {
+    return wait_for_frames(frames, timeout) && read_chunk(out, frames, info);
+}
+
+
+/**
+ * Blocking variant of acquire_chunk().
+ * - returns an empty span on timeout or stop
+ */
+std::span<const float> AudioEngine::acquire_chunk_blocking(ma_uint32 frames, std::chrono::nanoseconds timeout, ChunkInfo* info) {
+    if (!wait_for_frames(frames, timeout)) return {};
+    return acquire_chunk(frames, info);
+}
+
+
 /**
  * Device enumeration (static)
  * - Lists all detected audio capture devices without needing an engine instance
+ * - served from the DeviceRegistry cache, the backend is only probed once
  */
 std::vector<std::string> AudioEngine::get_capture_devices() {
-    ma_context ctx;
     std::vector<std::string> devices;
-
-    if (ma_context_init(nullptr, 0, nullptr, &ctx) != MA_SUCCESS) return devices; 
-
-    ma_device_info* infos;
-    ma_uint32 count;
-    ma_context_get_devices(&ctx, nullptr, nullptr, &infos, &count);
-
-    for (ma_uint32 i = 0; i < count; ++i) {
-        devices.emplace_back(infos[i].name);
+    for (const CaptureDeviceInfo& info : DeviceRegistry::instance().get_capture_devices()) {
+        devices.push_back(info.name);
     }
-
-    ma_context_uninit(&ctx);
     return devices;
 }
 
@@ -171,7 +725,10 @@ std::vector<std::string> AudioEngine::get_capture_devices() {
  * Destroy the audio engine and release all resources used
  */
 AudioEngine::~AudioEngine() {
+    stop();
+
     if (device_initialized) ma_device_uninit(&audio_device);
-    if (ring_buffer_initialized) ma_pcm_rb_uninit(&ring_buffer);
-    if (context_initialized) ma_context_uninit(&context);
+    if (decoder_initialized) ma_decoder_uninit(&decoder);
+    if (waveform_initialized) ma_waveform_uninit(&waveform);
+    if (noise_initialized) ma_noise_uninit(&noise, nullptr);
 }
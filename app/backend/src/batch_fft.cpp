@@ -0,0 +1,153 @@
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#include "batch_fft.hpp"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define BATCH_FFT_HAVE_SIMD 1
+
+// kissfft/kiss_fft_simd4.c: kiss_fftr built with kiss_fft_scalar = __m128
+extern "C" {
+void* kiss_fftr_simd4_alloc(int nfft, int inverse_fft, void* mem, size_t* lenmem);
+void kiss_fftr_simd4(void* cfg, const __m128* timedata, __m128* freqdata);
+void kiss_fftr_simd4_free(void* cfg);
+}
+
+static void free_config(void* cfg) { kiss_fftr_simd4_free(cfg); }
+#else
+#include "kiss_fftr.h"
+
+static void free_config(void* cfg) { kiss_fftr_free(cfg); }
+#endif
+
+
+static float* alloc_aligned(size_t floats) {
+    // every buffer is a whole number of __m128
+    return static_cast<float*>(std::aligned_alloc(16, (floats * sizeof(float) + 15) & ~size_t(15)));
+}
+
+
+BatchFft4::BatchFft4(uint32_t size) : fft_size(size) {
+    if (size == 0 || size % 2 != 0) throw std::invalid_argument("batch FFT needs an even size");
+
+    const size_t bins = size / 2 + 1;
+    time_data = alloc_aligned(size_t(size) * BATCH_FFT_LANES);
+    freq_data = alloc_aligned(bins * 2 * BATCH_FFT_LANES);
+
+#if defined(BATCH_FFT_HAVE_SIMD)
+    config = kiss_fftr_simd4_alloc(int(size), 0, nullptr, nullptr);
+#else
+    config = kiss_fftr_alloc(int(size), 0, nullptr, nullptr);
+    lane_time.resize(size);
+    lane_freq.resize(bins * 2);
+#endif
+
+    if (!config || !time_data || !freq_data) {
+        std::free(time_data);
+        std::free(freq_data);
+        if (config) free_config(config);
+        throw std::bad_alloc();
+    }
+}
+
+
+BatchFft4::~BatchFft4() {
+    free_config(config);
+    std::free(time_data);
+    std::free(freq_data);
+}
+
+
+uint32_t BatchFft4::size() const {
+    return fft_size;
+}
+
+
+bool BatchFft4::simd_available() {
+#if defined(BATCH_FFT_HAVE_SIMD)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/**
+ * Interleave four frames of size() samples into the lane layout.
+ * - 4x4 blocks are transposed in registers, the odd pair at the end is scalar
+ */
+void BatchFft4::load(const float* const frames[BATCH_FFT_LANES]) {
+    size_t n = 0;
+#if defined(BATCH_FFT_HAVE_SIMD)
+    for (; n + 4 <= fft_size; n += 4) {
+        __m128 a = _mm_loadu_ps(frames[0] + n);
+        __m128 b = _mm_loadu_ps(frames[1] + n);
+        __m128 c = _mm_loadu_ps(frames[2] + n);
+        __m128 d = _mm_loadu_ps(frames[3] + n);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+
+        float* dst = time_data + n * BATCH_FFT_LANES;
+        _mm_store_ps(dst, a);
+        _mm_store_ps(dst + 4, b);
+        _mm_store_ps(dst + 8, c);
+        _mm_store_ps(dst + 12, d);
+    }
+#endif
+    for (; n < fft_size; ++n) {
+        for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+            time_data[n * BATCH_FFT_LANES + lane] = frames[lane][n];
+        }
+    }
+}
+
+
+void BatchFft4::execute() {
+#if defined(BATCH_FFT_HAVE_SIMD)
+    kiss_fftr_simd4(config, reinterpret_cast<const __m128*>(time_data), reinterpret_cast<__m128*>(freq_data));
+#else
+    const size_t bins = fft_size / 2 + 1;
+    kiss_fftr_cfg cfg = static_cast<kiss_fftr_cfg>(config);
+
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        for (uint32_t n = 0; n < fft_size; ++n) {
+            lane_time[n] = time_data[n * BATCH_FFT_LANES + lane];
+        }
+        kiss_fftr(cfg, lane_time.data(), reinterpret_cast<kiss_fft_cpx*>(lane_freq.data()));
+        for (size_t k = 0; k < bins; ++k) {
+            freq_data[k * 8 + lane] = lane_freq[2 * k];
+            freq_data[k * 8 + 4 + lane] = lane_freq[2 * k + 1];
+        }
+    }
+#endif
+}
+
+
+/**
+ * Write every lane's size() / 2 + 1 bins as interleaved (re, im) pairs, the
+ * same layout as FftBackend::output(), so the per-frame kernels apply unchanged.
+ */
+void BatchFft4::spectra(float* const bins[BATCH_FFT_LANES]) const {
+    const size_t num_bins = fft_size / 2 + 1;
+
+    for (size_t k = 0; k < num_bins; ++k) {
+        const float* bin = freq_data + k * 8;
+#if defined(BATCH_FFT_HAVE_SIMD)
+        __m128 re = _mm_load_ps(bin);
+        __m128 im = _mm_load_ps(bin + 4);
+        __m128 lo = _mm_unpacklo_ps(re, im);    // re0 im0 re1 im1
+        __m128 hi = _mm_unpackhi_ps(re, im);    // re2 im2 re3 im3
+
+        _mm_storel_pi(reinterpret_cast<__m64*>(bins[0] + 2 * k), lo);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(bins[1] + 2 * k), lo);
+        _mm_storel_pi(reinterpret_cast<__m64*>(bins[2] + 2 * k), hi);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(bins[3] + 2 * k), hi);
+#else
+        for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+            bins[lane][2 * k] = bin[lane];
+            bins[lane][2 * k + 1] = bin[4 + lane];
+        }
+#endif
+    }
+}
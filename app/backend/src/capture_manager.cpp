@@ -0,0 +1,281 @@
+#include "capture_manager.hpp"
+
+
+CaptureManager::CaptureManager(const AudioEngineConfig& config, size_t worker_threads, ma_uint32 chunk_size)
+    : engine_config(config), chunk_frames(chunk_size), pool(worker_threads) {}
+
+
+CaptureManager::~CaptureManager() {
+    stop();
+}
+
+
+/**
+ * Register an input before init().
+ * - a feature sample rate other than the capture rate inserts a resampler
+ * - returns the input index used in InputFeatures and engine()
+ */
+size_t CaptureManager::add_input(const CaptureSourceConfig& source, const FeatureExtractorConfig& features) {
+    auto input = std::make_unique<Input>();
+    input->engine = std::make_unique<AudioEngine>(source, engine_config);
+    input->extractor = std::make_unique<FeatureExtractor>(features);
+
+    if (features.sample_rate != engine_config.sample_rate) {
+        ResamplerConfig resampler_config;
+        resampler_config.input_rate = engine_config.sample_rate;
+        resampler_config.output_rate = features.sample_rate;
+
+        input->resampler = std::make_unique<PolyphaseResampler>(resampler_config);
+        input->resampled.reserve(input->resampler->max_output_frames(chunk_frames));
+    }
+
+    inputs.push_back(std::move(input));
+    return inputs.size() - 1;
+}
+
+
+/**
+ * Initialize every input, stopping at the first failure.
+ * - returns config_failure when chunk_frames is zero or larger than the ring's
+ *   max_view_frames: acquire_chunk() could never hand out such a chunk, while the
+ *   buffered frames would keep waking the dispatcher
+ */
+AudioEngine::InitResult CaptureManager::init() {
+    if (chunk_frames == 0 || chunk_frames > engine_config.max_view_frames || chunk_frames > engine_config.ring_frames) {
+        return AudioEngine::InitResult::config_failure;
+    }
+
+    for (std::unique_ptr<Input>& input : inputs) {
+        AudioEngine::InitResult result = input->engine->init();
+        if (result != AudioEngine::InitResult::success) return result;
+
+        // every engine wakes the same dispatcher once a full chunk is buffered
+        input->engine->set_chunk_listener(&chunk_ready, chunk_frames);
+    }
+    return AudioEngine::InitResult::success;
+}
+
+
+/**
+ * Start all inputs back to back and begin dispatching chunks to the pool.
+ */
+void CaptureManager::start(FeatureCallback callback) {
+    if (running.exchange(true)) return;
+
+    on_features = std::move(callback);
+    chunk_ready.clear_interrupt();
+
+    start_time = std::chrono::steady_clock::now();
+    for (std::unique_ptr<Input>& input : inputs) {
+        input->flushed.store(false, std::memory_order_relaxed);
+        input->engine->start();
+    }
+
+    dispatcher = std::thread(&CaptureManager::dispatch_loop, this);
+}
+
+
+/**
+ * Stop dispatching, let in-flight chunks finish, then stop every input.
+ */
+void CaptureManager::stop() {
+    if (!running.exchange(false)) return;
+
+    chunk_ready.interrupt();
+    if (dispatcher.joinable()) dispatcher.join();
+    pool.wait_idle();
+
+    for (std::unique_ptr<Input>& input : inputs) {
+        input->engine->stop();
+    }
+}
+
+
+/**
+ * Block until every input has reached the end of its source and all of its audio,
+ * including the short final chunk and the resampler tail, has been processed.
+ * - only finite (file or fixed-duration synthetic) inputs ever drain
+ */
+bool CaptureManager::wait_until_drained(std::chrono::nanoseconds timeout) {
+    return chunk_ready.wait([this] { return is_drained(); }, timeout);
+}
+
+
+size_t CaptureManager::input_count() const {
+    return inputs.size();
+}
+
+
+AudioEngine& CaptureManager::engine(size_t input) {
+    return *inputs[input]->engine;
+}
+
+
+bool CaptureManager::has_ready_input() const {
+    for (const std::unique_ptr<Input>& input : inputs) {
+        if (!input->busy.load(std::memory_order_acquire) && has_work(*input)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * A full chunk is buffered, or the source has ended and its final chunk is still due.
+ */
+bool CaptureManager::has_work(const Input& input) const {
+    if (input.engine->available_frames() >= chunk_frames) return true;
+    return input.engine->is_source_exhausted() && !input.flushed.load(std::memory_order_acquire);
+}
+
+
+bool CaptureManager::is_drained() const {
+    if (jobs_in_flight.load(std::memory_order_acquire) > 0) return false;
+
+    for (const std::unique_ptr<Input>& input : inputs) {
+        if (!input->engine->is_source_exhausted() || !input->flushed.load(std::memory_order_acquire)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Dispatcher thread: sleep until some input has a full chunk, then claim the input
+ * and queue it on the pool.
+ * - an input is claimed with its `busy` flag, so at most one job per input is in flight
+ */
+void CaptureManager::dispatch_loop() {
+    while (running.load(std::memory_order_acquire)) {
+        chunk_ready.wait([this] { return !running.load(std::memory_order_acquire) || has_ready_input(); });
+        if (!running.load(std::memory_order_acquire)) break;
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            Input& input = *inputs[i];
+            if (input.busy.exchange(true, std::memory_order_acq_rel)) continue;
+
+            if (!has_work(input)) {
+                input.busy.store(false, std::memory_order_release);
+                continue;
+            }
+
+            jobs_in_flight.fetch_add(1, std::memory_order_acq_rel);
+            pool.submit([this, i] { process_chunk(i); });
+        }
+    }
+}
+
+
+/**
+ * Pool job: extract features from every full chunk currently buffered for one input,
+ * then from the final chunk once its source has ended.
+ * - runs with the input claimed, so its engine consumer side and extractor are ours
+ */
+void CaptureManager::process_chunk(size_t index) {
+    Input& input = *inputs[index];
+
+    ChunkInfo info;
+    std::span<const float> view = input.engine->acquire_chunk(chunk_frames, &info);
+
+    while (!view.empty()) {
+        const float* samples = view.data();
+        size_t sample_count = view.size();
+
+        if (input.resampler) {
+            input.resampled.clear();
+            input.resampler->process(view.data(), view.size(), input.resampled);
+            samples = input.resampled.data();
+            sample_count = input.resampled.size();
+        }
+        extract(index, info, samples, sample_count, false);
+
+        input.engine->release_chunk(chunk_frames);
+        view = input.engine->acquire_chunk(chunk_frames, &info);
+    }
+
+    // exhaustion is published after the source's last frames, so what is buffered now
+    // is everything that is left
+    if (input.engine->is_source_exhausted() && !input.flushed.load(std::memory_order_relaxed) &&
+        input.engine->available_frames() < chunk_frames) {
+        process_final_chunk(index);
+    }
+
+    input.busy.store(false, std::memory_order_release);
+    jobs_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+
+    // the input may have filled up again while we were busy with it
+    chunk_ready.notify();
+}
+
+
+/**
+ * The last frames of an exhausted source, fewer than chunk_frames and possibly none,
+ * followed by the resampler's filter tail.
+ */
+void CaptureManager::process_final_chunk(size_t index) {
+    Input& input = *inputs[index];
+
+    const ma_uint32 remainder = ma_uint32(input.engine->available_frames());
+    ChunkInfo info = input.engine->next_chunk_info();
+    std::span<const float> view;
+    if (remainder > 0) view = input.engine->acquire_chunk(remainder, &info);
+
+    const float* samples = view.data();
+    size_t sample_count = view.size();
+
+    if (input.resampler) {
+        input.resampled.clear();
+        input.resampler->process(view.data(), view.size(), input.resampled);
+        input.resampler->flush(input.resampled);
+        samples = input.resampled.data();
+        sample_count = input.resampled.size();
+    }
+    extract(index, info, samples, sample_count, true);
+
+    if (remainder > 0) input.engine->release_chunk(remainder);
+    input.flushed.store(true, std::memory_order_release);
+}
+
+
+/**
+ * Run one chunk's samples through the input's extractor and hand the rows to the
+ * feature callback.
+ */
+void CaptureManager::extract(size_t index, const ChunkInfo& info, const float* samples, size_t sample_count, bool final_chunk) {
+    Input& input = *inputs[index];
+
+    // sized for every frame this chunk can complete, only grows during warm-up
+    const FeatureExtractorConfig& extractor_config = input.extractor->get_config();
+    const uint32_t frame_size = extractor_config.num_mels;
+    const size_t max_frames = input.extractor->max_frames(uint32_t(sample_count));
+    input.features.resize(max_frames * frame_size);
+    if (extractor_config.spectral_descriptors) input.descriptors.resize(max_frames);
+    size_t frame_count = input.extractor->process_samples(samples, uint32_t(sample_count), std::span<float>(input.features),
+                                                          std::span<SpectralDescriptors>(input.descriptors));
+
+    InputFeatures features;
+    features.input = index;
+    features.chunk = info;
+    features.timestamp_sec = chunk_timestamp(input, info);
+    features.frames = std::span<const float>(input.features.data(), frame_count * frame_size);
+    if (!input.descriptors.empty()) features.descriptors = std::span<const SpectralDescriptors>(input.descriptors.data(), frame_count);
+    features.frame_count = frame_count;
+    features.frame_size = frame_size;
+    features.final_chunk = final_chunk;
+    if (on_features) on_features(features);
+}
+
+
+/**
+ * Capture time of a chunk's first frame relative to start().
+ */
+double CaptureManager::chunk_timestamp(const Input& input, const ChunkInfo& chunk) const {
+    double offset = 0.0;
+    std::optional<std::chrono::steady_clock::time_point> stream_start = input.engine->get_stream_start_time();
+    if (stream_start) {
+        offset = std::chrono::duration<double>(*stream_start - start_time).count();
+    }
+    return offset + double(chunk.first_frame) / engine_config.sample_rate;
+}
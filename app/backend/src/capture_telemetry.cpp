@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "capture_telemetry.hpp"
+
+
+/**
+ * Upper edge of a histogram bucket, as a fraction of the callback period.
+ * - the last bucket is open-ended
+ */
+double CaptureStats::bucket_upper_fraction(size_t bucket) {
+    if (bucket + 1 >= CALLBACK_TIMING_BUCKETS) return std::numeric_limits<double>::infinity();
+    return double(uint64_t(1) << bucket) / 256.0;
+}
+
+
+void CaptureTelemetry::set_ring_capacity(uint64_t frames) {
+    ring_capacity.store(frames, std::memory_order_relaxed);
+}
+
+
+/**
+ * Single-writer increment: a load/store pair is enough because only the audio
+ * thread writes, and it avoids a locked instruction per counter.
+ */
+void CaptureTelemetry::bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+
+/**
+ * Account for one capture callback, called from the real-time audio thread.
+ * - `period_ns` is the wall-clock duration of the frames delivered in this callback,
+ *   i.e. the time budget the callback had before the next one arrives
+ */
+void CaptureTelemetry::record_callback(
+    uint64_t frames_written,
+    uint64_t dropped,
+    uint64_t ring_fill_frames,
+    uint64_t elapsed_ns,
+    uint64_t period_ns
+) {
+    bump(callbacks, 1);
+    bump(frames_captured, frames_written);
+    if (dropped > 0) {
+        bump(frames_dropped, dropped);
+        bump(overrun_callbacks, 1);
+    }
+
+    ring_fill.store(ring_fill_frames, std::memory_order_relaxed);
+    if (ring_fill_frames > ring_high_water.load(std::memory_order_relaxed)) {
+        ring_high_water.store(ring_fill_frames, std::memory_order_relaxed);
+    }
+
+    last_callback_ns.store(elapsed_ns, std::memory_order_relaxed);
+    if (elapsed_ns > max_callback_ns.load(std::memory_order_relaxed)) {
+        max_callback_ns.store(elapsed_ns, std::memory_order_relaxed);
+    }
+    if (elapsed_ns > period_ns) {
+        bump(over_budget_callbacks, 1);
+    }
+
+    // log2 bucket of elapsed / period in 1/256 steps
+    uint64_t ratio = period_ns > 0 ? elapsed_ns * 256 / period_ns : UINT64_MAX;
+    size_t bucket = std::min<size_t>(std::bit_width(ratio), CALLBACK_TIMING_BUCKETS - 1);
+    bump(histogram[bucket], 1);
+}
+
+
+/**
+ * Copy the counters out.
+ * - fields are read individually, so a snapshot taken mid-callback may mix two
+ *   consecutive callbacks; each value on its own is always consistent
+ */
+CaptureStats CaptureTelemetry::snapshot() const {
+    CaptureStats stats;
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.frames_captured = frames_captured.load(std::memory_order_relaxed);
+    stats.frames_dropped = frames_dropped.load(std::memory_order_relaxed);
+    stats.overrun_callbacks = overrun_callbacks.load(std::memory_order_relaxed);
+
+    stats.ring_fill_frames = ring_fill.load(std::memory_order_relaxed);
+    stats.ring_high_water_frames = ring_high_water.load(std::memory_order_relaxed);
+    stats.ring_capacity_frames = ring_capacity.load(std::memory_order_relaxed);
+
+    stats.last_callback_ns = last_callback_ns.load(std::memory_order_relaxed);
+    stats.max_callback_ns = max_callback_ns.load(std::memory_order_relaxed);
+    stats.over_budget_callbacks = over_budget_callbacks.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < CALLBACK_TIMING_BUCKETS; ++i) {
+        stats.callback_time_histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+
+/**
+ * Zero every counter.
+ * - only call while the audio thread is not running, it is the sole writer otherwise
+ */
+void CaptureTelemetry::reset() {
+    for (std::atomic<uint64_t>* counter : {
+        &callbacks, &frames_captured, &frames_dropped, &overrun_callbacks,
+        &ring_fill, &ring_high_water, &last_callback_ns, &max_callback_ns, &over_budget_callbacks
+    }) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<uint64_t>& bucket : histogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+#include "chroma.hpp"
+#include "simd_kernels.hpp"
+
+// piptrack defaults used by estimate_tuning
+static constexpr double TUNING_FMIN = 150.0;
+static constexpr double TUNING_FMAX = 4000.0;
+static constexpr float TUNING_PEAK_THRESHOLD = 0.1f;
+
+
+ChromaExtractor::ChromaExtractor(const ChromaConfig& c) : config(c) {
+    if (config.sample_rate == 0 || config.fft_size < 2) {
+        throw std::invalid_argument("chroma needs a sample rate and an FFT size of at least 2");
+    }
+    build_filters();
+}
+
+
+/**
+ * librosa.filters.chroma(sr, n_fft, tuning), cut to runs of weights above the floor.
+ */
+void ChromaExtractor::build_filters() {
+    const uint32_t bins = config.fft_size / 2 + 1;
+    const double n_chroma = NUM_CHROMA;
+    const double half_chroma = std::round(n_chroma / 2);
+    const double a440 = 440.0 * std::exp2(config.tuning / n_chroma);
+
+    // chroma-bin position of every FFT bin; bin 0 is put 1.5 octaves below bin 1
+    std::vector<double> position(bins + 1);
+    for (uint32_t k = 1; k <= bins; ++k) {
+        double hz = double(k) * config.sample_rate / config.fft_size;
+        position[k] = n_chroma * std::log2(hz / (a440 / 16.0));
+    }
+    position[0] = position[1] - 1.5 * n_chroma;
+
+    std::vector<float> dense(size_t(NUM_CHROMA) * bins);
+    double column[NUM_CHROMA];
+    float largest = 0.0f;
+
+    for (uint32_t k = 0; k < bins; ++k) {
+        double width = std::max(position[k + 1] - position[k], 1.0);
+        double norm = 0.0;
+        for (uint32_t c = 0; c < NUM_CHROMA; ++c) {
+            double d = position[k] - c + half_chroma + 10.0 * n_chroma;
+            d = d - n_chroma * std::floor(d / n_chroma) - half_chroma;
+            column[c] = std::exp(-0.5 * (2.0 * d / width) * (2.0 * d / width));
+            norm += column[c] * column[c];
+        }
+        norm = std::sqrt(norm);
+
+        double octave = (position[k] / n_chroma - 5.0) / 2.0;
+        double scale = std::exp(-0.5 * octave * octave) / (norm > DBL_MIN ? norm : 1.0);
+
+        // base_c: row 0 is C, three chroma bins above A
+        for (uint32_t c = 0; c < NUM_CHROMA; ++c) {
+            float w = float(column[(c + 3) % NUM_CHROMA] * scale);
+            dense[size_t(c) * bins + k] = w;
+            largest = std::max(largest, w);
+        }
+    }
+
+    const float floor = config.weight_floor * largest;
+    runs.clear();
+    weights.clear();
+    for (uint32_t c = 0; c < NUM_CHROMA; ++c) {
+        const float* row = dense.data() + size_t(c) * bins;
+        uint32_t k = 0;
+        while (k < bins) {
+            if (row[k] <= floor) {
+                ++k;
+                continue;
+            }
+            ChromaRun run{c, k, 0, uint32_t(weights.size())};
+            for (; k < bins && row[k] > floor; ++k) weights.push_back(row[k]);
+            run.length = k - run.first_bin;
+            runs.push_back(run);
+        }
+    }
+}
+
+
+/**
+ * NUM_CHROMA values, C first, from fft_size / 2 + 1 power bins.
+ */
+void ChromaExtractor::compute(const float* power, float* chroma) const {
+    std::fill(chroma, chroma + NUM_CHROMA, 0.0f);
+    for (const ChromaRun& run : runs) {
+        chroma[run.chroma] += simd::dot(weights.data() + run.offset, power + run.first_bin, run.length);
+    }
+
+    float peak = *std::max_element(chroma, chroma + NUM_CHROMA);
+    if (peak > FLT_MIN) {
+        for (uint32_t c = 0; c < NUM_CHROMA; ++c) chroma[c] /= peak;
+    }
+}
+
+
+void ChromaExtractor::set_tuning(float tuning) {
+    if (tuning == config.tuning) return;
+    config.tuning = tuning;
+    build_filters();
+}
+
+
+float ChromaExtractor::get_tuning() const {
+    return config.tuning;
+}
+
+
+/**
+ * Filter weights kept after the floor, the multiply-adds per frame.
+ */
+size_t ChromaExtractor::weight_count() const {
+    return weights.size();
+}
+
+
+const ChromaConfig& ChromaExtractor::get_config() const {
+    return config;
+}
+
+
+TuningEstimator::TuningEstimator(uint32_t sr, uint32_t n_fft, float res)
+    : sample_rate(sr), fft_size(n_fft), resolution(res) {
+    if (sr == 0 || n_fft < 4 || !(res > 0.0f && res <= 1.0f)) {
+        throw std::invalid_argument("tuning estimation needs a sample rate, an FFT size of at least 4 and 0 < resolution <= 1");
+    }
+
+    // bins strictly inside the spectrum, so both neighbours exist
+    const uint32_t bins = n_fft / 2 + 1;
+    const double bin_hz = double(sr) / n_fft;
+    first_bin = std::max(uint32_t(std::ceil(TUNING_FMIN / bin_hz)), 1u);
+    end_bin = std::min(uint32_t(std::ceil(TUNING_FMAX / bin_hz)), bins - 1);
+    end_bin = std::max(end_bin, first_bin);
+
+    histogram.assign(size_t(std::ceil(1.0f / resolution)), 0);
+    peak_pitches.reserve(end_bin - first_bin);
+    peak_magnitudes.reserve(end_bin - first_bin);
+    median_scratch.reserve(end_bin - first_bin);
+}
+
+
+/**
+ * One frame's fft_size / 2 + 1 power bins.
+ */
+void TuningEstimator::push(const float* power) {
+    const uint32_t bins = fft_size / 2 + 1;
+    const float threshold = TUNING_PEAK_THRESHOLD * *std::max_element(power, power + bins);
+
+    peak_pitches.clear();
+    peak_magnitudes.clear();
+    for (uint32_t k = first_bin; k < end_bin; ++k) {
+        // localmax of S * (S > threshold)
+        float s = power[k] > threshold ? power[k] : 0.0f;
+        float left = power[k - 1] > threshold ? power[k - 1] : 0.0f;
+        float right = power[k + 1] > threshold ? power[k + 1] : 0.0f;
+        if (!(s > left && s >= right)) continue;
+
+        float avg = 0.5f * (power[k + 1] - power[k - 1]);
+        float curvature = 2.0f * power[k] - power[k + 1] - power[k - 1];
+        float shift = avg / (curvature + (std::fabs(curvature) < FLT_MIN ? 1.0f : 0.0f));
+        float pitch = (float(k) + shift) * float(sample_rate) / float(fft_size);
+        if (pitch <= 0.0f) continue;
+
+        peak_pitches.push_back(pitch);
+        peak_magnitudes.push_back(power[k] + 0.5f * avg * shift);
+    }
+    if (peak_pitches.empty()) return;
+
+    // np.median: mean of the two middle values for an even count
+    median_scratch.assign(peak_magnitudes.begin(), peak_magnitudes.end());
+    const size_t half = median_scratch.size() / 2;
+    std::nth_element(median_scratch.begin(), median_scratch.begin() + half, median_scratch.end());
+    float median = median_scratch[half];
+    if (median_scratch.size() % 2 == 0) {
+        median = 0.5f * (median + *std::max_element(median_scratch.begin(), median_scratch.begin() + half));
+    }
+
+    const uint32_t slots = uint32_t(histogram.size());
+    for (size_t i = 0; i < peak_pitches.size(); ++i) {
+        if (peak_magnitudes[i] < median) continue;
+
+        // pitch_tuning: distance to the nearest semitone of the A440 grid, in [-0.5, 0.5)
+        double semitones = NUM_CHROMA * std::log2(double(peak_pitches[i]) / (440.0 / 16.0));
+        double residual = semitones - std::floor(semitones);
+        if (residual >= 0.5) residual -= 1.0;
+
+        uint32_t slot = std::min(uint32_t((residual + 0.5) / resolution), slots - 1);
+        ++histogram[slot];
+        ++peaks;
+    }
+}
+
+
+/**
+ * Tuning in fractions of a chroma bin, ChromaConfig::tuning.
+ */
+float TuningEstimator::estimate() const {
+    if (peaks == 0) return 0.0f;
+    size_t best = size_t(std::max_element(histogram.begin(), histogram.end()) - histogram.begin());
+    return -0.5f + float(best) * resolution;
+}
+
+
+void TuningEstimator::reset() {
+    std::fill(histogram.begin(), histogram.end(), 0);
+    peaks = 0;
+}
+
+
+uint64_t TuningEstimator::peak_count() const {
+    return peaks;
+}
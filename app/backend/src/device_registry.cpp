@@ -0,0 +1,193 @@
+#include <cstdio>
+#include <iostream>
+
+#include "device_registry.hpp"
+
+
+/**
+ * The one registry per process, constructed on first use.
+ */
+DeviceRegistry& DeviceRegistry::instance() {
+    static DeviceRegistry registry;
+    return registry;
+}
+
+
+/**
+ * Create the shared miniaudio context if it does not exist yet.
+ * - a failed attempt is remembered, so a missing backend is only probed once
+ * - caller must hold `mutex`
+ */
+bool DeviceRegistry::ensure_context() {
+    if (context_initialized) return true;
+    if (context_failed) return false;
+
+    if (ma_context_init(nullptr, 0, nullptr, &context) != MA_SUCCESS) {
+        std::cerr << "failed to initialize audio context \n";
+        context_failed = true;
+        return false;
+    }
+
+    context_initialized = true;
+    return true;
+}
+
+
+/**
+ * Shared context for device initialization, nullptr when no backend is available.
+ * - owned by the registry, never uninit it
+ */
+ma_context* DeviceRegistry::get_context() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ensure_context() ? &context : nullptr;
+}
+
+
+/**
+ * Stable identifier for a device: backend name plus a hash of the backend device ID.
+ */
+std::string DeviceRegistry::make_stable_id(const ma_context& ctx, const ma_device_id& id) {
+    // FNV-1a over the raw ID, miniaudio zero-fills the unused part of the union
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&id);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(ma_device_id); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(ma_get_backend_name(ctx.backend)) + ":" + hex;
+}
+
+
+/**
+ * Re-read the capture device list from the backend.
+ * - returns true when the set of devices changed
+ * - caller must hold `mutex`
+ */
+bool DeviceRegistry::enumerate_locked() {
+    if (!ensure_context()) return false;
+
+    ma_device_info* capture_infos;
+    ma_uint32 capture_count;
+    if (ma_context_get_devices(&context, nullptr, nullptr, &capture_infos, &capture_count) != MA_SUCCESS) {
+        return false;
+    }
+
+    std::vector<CaptureDeviceInfo> fresh;
+    fresh.reserve(capture_count);
+    for (ma_uint32 i = 0; i < capture_count; ++i) {
+        CaptureDeviceInfo info;
+        info.stable_id = make_stable_id(context, capture_infos[i].id);
+        info.name = capture_infos[i].name;
+        info.id = capture_infos[i].id;
+        info.is_default = capture_infos[i].isDefault;
+        fresh.push_back(info);
+    }
+
+    bool changed = !enumerated || fresh.size() != devices.size();
+    for (size_t i = 0; !changed && i < fresh.size(); ++i) {
+        changed = fresh[i].stable_id != devices[i].stable_id || fresh[i].name != devices[i].name;
+    }
+
+    devices = std::move(fresh);
+    enumerated = true;
+    if (changed) list_generation.fetch_add(1, std::memory_order_release);
+
+    return changed;
+}
+
+
+/**
+ * Cached capture devices, enumerating on the first call only.
+ */
+std::vector<CaptureDeviceInfo> DeviceRegistry::get_capture_devices() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enumerated) enumerate_locked();
+    return devices;
+}
+
+
+/**
+ * Look a device up by its stable ID.
+ */
+std::optional<CaptureDeviceInfo> DeviceRegistry::find_device(const std::string& stable_id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enumerated) enumerate_locked();
+
+    for (const CaptureDeviceInfo& info : devices) {
+        if (info.stable_id == stable_id) return info;
+    }
+    return std::nullopt;
+}
+
+
+/**
+ * Look a device up by its position in the cached list.
+ */
+std::optional<CaptureDeviceInfo> DeviceRegistry::device_at(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enumerated) enumerate_locked();
+
+    if (index >= devices.size()) return std::nullopt;
+    return devices[index];
+}
+
+
+/**
+ * Force a synchronous re-enumeration.
+ * - returns true when the device list changed
+ */
+bool DeviceRegistry::refresh() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return enumerate_locked();
+}
+
+
+/**
+ * Increases every time the cached device list changes.
+ * - cheap to poll from a UI loop to decide whether to redraw
+ */
+uint64_t DeviceRegistry::generation() const {
+    return list_generation.load(std::memory_order_acquire);
+}
+
+
+/**
+ * Re-enumerate in the background so hotplugged devices show up without blocking callers.
+ * - miniaudio has no portable hotplug notification, so this polls at `interval`
+ * - calling it again while the monitor is running does nothing
+ */
+void DeviceRegistry::start_hotplug_monitor(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(monitor_mutex);
+    if (monitor_running) return;
+    monitor_running = true;
+
+    monitor_thread = std::thread([this, interval] {
+        std::unique_lock<std::mutex> monitor_lock(monitor_mutex);
+        while (monitor_running) {
+            monitor_lock.unlock();
+            refresh();
+            monitor_lock.lock();
+
+            monitor_cv.wait_for(monitor_lock, interval, [this] { return !monitor_running; });
+        }
+    });
+}
+
+
+void DeviceRegistry::stop_hotplug_monitor() {
+    {
+        std::lock_guard<std::mutex> lock(monitor_mutex);
+        monitor_running = false;
+    }
+    monitor_cv.notify_all();
+
+    if (monitor_thread.joinable()) monitor_thread.join();
+}
+
+
+DeviceRegistry::~DeviceRegistry() {
+    stop_hotplug_monitor();
+    if (context_initialized) ma_context_uninit(&context);
+}
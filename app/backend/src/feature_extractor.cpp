@@ -3,137 +3,237 @@
 #include <cstring>
 
 #include "feature_extractor.hpp"
+#include "simd_kernels.hpp"
 
 
-float FeatureExtractor::hz_to_mel(float hz) {
-    return 2595.0f * std::log10(1.0f + hz / 700.0f);
-}
+FeatureExtractor::FeatureExtractor(const FeatureExtractorConfig& c)
+    : config(c), assembler(c.fft_size, c.hop_size) {
+    if (config.fmax < 0.0f) config.fmax = 0.5f * config.sample_rate;
+
+    tables = AnalysisTables::acquire({config.sample_rate, config.fft_size, config.num_mels, config.fmin, config.fmax,
+                                      config.mel_scale, config.periodic_window});
+    fft = make_fft_backend(config.fft_backend, config.fft_size);
+    power_spectrum.resize(config.fft_size / 2 + 1);
+    mel_power.resize(config.num_mels);
+    magnitude_scratch.resize(power_spectrum.size());
 
-float FeatureExtractor::mel_to_hz(float mel) {
-    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+    frame_scratch.resize(config.num_mels);
 }
 
 
-FeatureExtractor::FeatureExtractor(const FeatureExtractorConfig& c) : config(c) {
-    if (config.fmax < 0.0f) config.fmax = 0.5f * config.sample_rate;
+FeatureExtractor::~FeatureExtractor() = default;
 
-    window.resize(config.fft_size);
-    fft_input.resize(config.fft_size, 0.0f);
-    fft_output.resize(config.fft_size / 2 + 1);
-    power_spectrum.resize(config.fft_size / 2 + 1);
 
-    overlap_buffer.reserve(config.fft_size);
+// what compute_spectral_descriptors() gives for an all-zero spectrum
+static constexpr SpectralDescriptors SILENT_DESCRIPTORS = {0.0f, 0.0f, 0.0f, 1.0f};
 
-    build_hann_window();
-    build_mel_filterbank();
 
-    fft_config = kiss_fftr_alloc(config.fft_size, 0, nullptr, nullptr);
+/**
+ * One log-mel frame: window, FFT, power spectrum, mel projection, dB with top_db floor.
+ * - writes `num_mels` values to `out`, allocation-free
+ * - every per-bin loop runs through the runtime-dispatched simd kernels
+ * - with `descriptors`, the same power spectrum also gives the frame's
+ *   SpectralDescriptors (one more sweep over the bins, still cache-hot)
+ */
+void FeatureExtractor::compute_frame(const float* frame, float* out, SpectralDescriptors* descriptors) {
+    float energy_sum = simd::apply_window(frame, tables->window.data(), fft->input(), config.fft_size);
+
+    if (energy_sum < config.silence_threshold) {
+        std::fill(out, out + config.num_mels, -config.top_db);
+        if (descriptors) *descriptors = SILENT_DESCRIPTORS;
+        return;
+    }
+
+    fft->execute();
+    simd::power_spectrum(fft->output(), power_spectrum.size(), power_spectrum.data());
+    project_frame(power_spectrum.data(), out);
+
+    if (descriptors) {
+        *descriptors = compute_spectral_descriptors(power_spectrum.data(), tables->bin_frequencies.data(),
+                                                    power_spectrum.size(), magnitude_scratch.data());
+    }
 }
 
 
-FeatureExtractor::~FeatureExtractor() {
-    free(fft_config);
+/**
+ * Linear mel power of one frame (window, FFT, |X|^2, mel projection), `num_mels` values.
+ * - no dB conversion and no silence gate, for callers that normalise over a whole
+ *   signal (see LibrosaMelSpectrogram)
+ */
+void FeatureExtractor::compute_mel_power(const float* frame, float* out) {
+    compute_power_spectrum(frame);
+    project_mel_power(power_spectrum.data(), out);
 }
 
 
-void FeatureExtractor::build_hann_window() {
-    for (uint32_t i = 0; i < config.fft_size; ++i) {
-        window[i] = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (config.fft_size - 1)));
-    }
+/**
+ * Power spectrum of one frame (window, FFT, |X|^2), `fft_size / 2 + 1` bins.
+ * - the span points into the extractor and is overwritten by the next frame
+ * - lets callers derive several features from one transform (see GenreFeatureExtractor)
+ */
+std::span<const float> FeatureExtractor::compute_power_spectrum(const float* frame) {
+    simd::apply_window(frame, tables->window.data(), fft->input(), config.fft_size);
+    fft->execute();
+    simd::power_spectrum(fft->output(), power_spectrum.size(), power_spectrum.data());
+    return power_spectrum;
 }
 
 
-void FeatureExtractor::build_mel_filterbank() {
-    mel_filterbank.assign(config.num_mels, std::vector<float>(config.fft_size / 2 + 1, 0.0f));
+/**
+ * Linear mel power of a power spectrum from compute_power_spectrum(), `num_mels` values.
+ */
+void FeatureExtractor::project_mel_power(const float* power, float* out) const {
+    tables->mel_filterbank.project(power, out);
+}
 
-    float mel_min = hz_to_mel(config.fmin);
-    float mel_max = hz_to_mel(config.fmax);
 
-    std::vector<float> mel_points(config.num_mels + 2);
-    std::vector<int> bin_points(config.num_mels + 2);
+/**
+ * Four independent frames at once, e.g. consecutive hops or four streams.
+ * - the transforms share one 4-wide kissfft pass; each output is bit-identical to
+ *   compute_frame() on the same frame
+ * - with a non-kissfft backend the frames simply go through compute_frame()
+ * - `descriptors`, when given, takes one SpectralDescriptors per lane
+ */
+void FeatureExtractor::compute_frames4(const float* const frames[BATCH_FFT_LANES], float* const out[BATCH_FFT_LANES],
+                                       SpectralDescriptors* descriptors) {
+    if (fft->kind() != FftBackendKind::kiss) {
+        for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+            compute_frame(frames[lane], out[lane], descriptors ? descriptors + lane : nullptr);
+        }
+        return;
+    }
 
-    int max_bin = config.fft_size / 2;
+    const size_t bins = power_spectrum.size();
+    if (!batch_fft) {
+        batch_fft = std::make_unique<BatchFft4>(config.fft_size);
+        batch_windowed.resize(size_t(BATCH_FFT_LANES) * config.fft_size);
+        batch_bins.resize(size_t(BATCH_FFT_LANES) * 2 * bins);
+    }
 
-    for (uint32_t i = 0; i < mel_points.size(); ++i) {
-        mel_points[i] = mel_min + (mel_max - mel_min) * i / (config.num_mels + 1);
+    const float* windowed[BATCH_FFT_LANES];
+    float* spectra[BATCH_FFT_LANES];
+    bool silent[BATCH_FFT_LANES];
 
-        float hz = mel_to_hz(mel_points[i]);
-        bin_points[i] = std::min(max_bin, int(std::floor((config.fft_size + 1) * hz / config.sample_rate)));
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        float* dst = batch_windowed.data() + size_t(lane) * config.fft_size;
+        silent[lane] = simd::apply_window(frames[lane], tables->window.data(), dst, config.fft_size) < config.silence_threshold;
+        windowed[lane] = dst;
+        spectra[lane] = batch_bins.data() + lane * 2 * bins;
     }
 
-    for (uint32_t m = 1; m <= config.num_mels; ++m) {
-        for (int k = bin_points[m - 1]; k < bin_points[m]; ++k) {
-            mel_filterbank[m - 1][k] = float(k - bin_points[m - 1]) / (bin_points[m] - bin_points[m - 1]);
-        }
+    batch_fft->load(windowed);
+    batch_fft->execute();
+    batch_fft->spectra(spectra);
 
-        for (int k = bin_points[m]; k < bin_points[m + 1]; ++k) {
-            mel_filterbank[m - 1][k] = float(bin_points[m + 1] - k) / (bin_points[m + 1] - bin_points[m]);
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        if (silent[lane]) {
+            std::fill(out[lane], out[lane] + config.num_mels, -config.top_db);
+            if (descriptors) descriptors[lane] = SILENT_DESCRIPTORS;
+            continue;
         }
+        simd::power_spectrum(spectra[lane], bins, power_spectrum.data());
+        project_frame(power_spectrum.data(), out[lane]);
 
-        float sum = 0.0f;
-        for (float v : mel_filterbank[m - 1]) {
-            sum += v;
-        } 
-        if (sum > 0.0f) {
-            for (float& v : mel_filterbank[m - 1]) {
-                v /= sum;
-            }
-        } 
+        if (descriptors) {
+            descriptors[lane] = compute_spectral_descriptors(power_spectrum.data(), tables->bin_frequencies.data(),
+                                                             bins, magnitude_scratch.data());
+        }
     }
 }
 
 
-std::vector<float> FeatureExtractor::compute_frame(const float* frame) {
-    float energy_sum = 0.0f;
+/**
+ * Mel projection and dB conversion of one power spectrum into `num_mels` values.
+ */
+void FeatureExtractor::project_frame(const float* power, float* out) {
+    tables->mel_filterbank.project(power, mel_power.data());
 
-    for (uint32_t i = 0; i < config.fft_size; ++i) {
-        fft_input[i] = frame[i] * window[i];
-        energy_sum += std::abs(frame[i]);
-    }
+    float max_db = simd::power_to_db(mel_power.data(), config.num_mels, config.eps, out);
+
+    float min_db = max_db - config.top_db;
+    for (uint32_t m = 0; m < config.num_mels; ++m)
+        out[m] = std::max(out[m], min_db);
+}
 
-    std::vector<float> mel(config.num_mels, -config.top_db);
 
-    if (energy_sum < config.silence_threshold)
-        return mel;
+/**
+ * Where for_each_frame() puts descriptors: nowhere unless the config asks for them.
+ */
+SpectralDescriptors* FeatureExtractor::streaming_descriptors() {
+    return config.spectral_descriptors ? &last_descriptors : nullptr;
+}
 
-    kiss_fftr(fft_config, fft_input.data(), fft_output.data());
 
-    for (size_t i = 0; i < power_spectrum.size(); ++i) {
-        float re = fft_output[i].r;
-        float im = fft_output[i].i;
-        power_spectrum[i] = re * re + im * im;
-    }
+std::vector<std::vector<float>> FeatureExtractor::process_samples(const float* input, uint32_t num_samples) {
+    std::vector<std::vector<float>> frames;
 
-    float max_db = -1e9f;
+    for_each_frame(input, num_samples, [&](std::span<const float> frame) {
+        frames.emplace_back(frame.begin(), frame.end());
+    });
 
-    for (uint32_t m = 0; m < config.num_mels; ++m) {
-        float sum = 0.0f;
-        for (size_t k = 0; k < power_spectrum.size(); ++k)
-            sum += power_spectrum[k] * mel_filterbank[m][k];
+    return frames;
+}
 
-        float db = 10.0f * std::log10(sum + config.eps);
-        mel[m] = db;
-        max_db = std::max(max_db, db);
-    }
 
-    float min_db = max_db - config.top_db;
-    for (float& v : mel)
-        v = std::max(v, min_db);
+/**
+ * Feed samples and write completed frames row by row into `out` (num_mels per row).
+ * - a non-empty `descriptors` gets one SpectralDescriptors per row, row i's in
+ *   descriptors[i]; it then also bounds the rows written
+ * - returns the number of frames written
+ * - frames that do not fit stay buffered and are written by the next call, size
+ *   `out` (and `descriptors`) with max_frames() to get them all at once
+ */
+size_t FeatureExtractor::process_samples(const float* input, uint32_t num_samples, std::span<float> out,
+                                         std::span<SpectralDescriptors> descriptors) {
+    size_t capacity = out.size() / config.num_mels;
+    if (!descriptors.empty()) capacity = std::min(capacity, descriptors.size());
+
+    return assembler.fill_frames(input, num_samples, capacity, [&](const float* frame, size_t row) {
+        SpectralDescriptors* row_descriptors = descriptors.empty() ? nullptr : &descriptors[row];
+        compute_frame(frame, out.data() + row * config.num_mels, row_descriptors);
+    });
+}
 
-    return mel;
+
+/**
+ * Frames the next call can produce after receiving `num_samples` more samples.
+ */
+size_t FeatureExtractor::max_frames(uint32_t num_samples) const {
+    return assembler.max_frames(num_samples);
 }
 
 
-std::vector<std::vector<float>> FeatureExtractor::process_samples(const float* input, uint32_t num_samples) {
-    std::vector<std::vector<float>> frames;
+/**
+ * Complete frames already buffered but not yet emitted.
+ */
+size_t FeatureExtractor::pending_frames() const {
+    return assembler.max_frames(0);
+}
 
-    overlap_buffer.insert(overlap_buffer.end(), input, input + num_samples);
 
-    while (overlap_buffer.size() >= config.fft_size) {
-        frames.push_back(compute_frame(overlap_buffer.data()));
+const FeatureExtractorConfig& FeatureExtractor::get_config() const {
+    return config;
+}
 
-        overlap_buffer.erase(overlap_buffer.begin(), overlap_buffer.begin() + config.hop_size);
-    }
 
-    return frames;
+/**
+ * Descriptors of the frame for_each_frame() is visiting (`spectral_descriptors` set).
+ * - the span overload writes its rows' descriptors to its `descriptors` argument
+ *   and leaves this untouched
+ */
+const SpectralDescriptors& FeatureExtractor::frame_descriptors() const {
+    return last_descriptors;
+}
+
+
+/**
+ * Centre frequency in Hz of every power spectrum bin.
+ */
+std::span<const float> FeatureExtractor::bin_frequencies() const {
+    return tables->bin_frequencies;
+}
+
+
+FftBackendKind FeatureExtractor::get_fft_backend() const {
+    return fft->kind();
 }
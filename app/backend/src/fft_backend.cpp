@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "fft_backend.hpp"
+#include "kiss_fft.h"
+#include "shared_table_cache.hpp"
+
+#if __has_include(<fftw3.h>)
+#include <fftw3.h>
+#define FFT_BACKEND_HAVE_FFTW 1
+#endif
+
+
+/**
+ * Twiddles and factorisation of one kissfft size, read-only once built.
+ * - the complex N/2 state is never written by kiss_fft() (its scratch is the
+ *   output buffer), so one copy serves every backend of that size
+ */
+struct KissTables {
+    kiss_fft_cfg complex_config = nullptr;
+    std::vector<kiss_fft_cpx> super_twiddles;
+
+    explicit KissTables(uint32_t size) {
+        const uint32_t half = size / 2;
+        complex_config = kiss_fft_alloc(int(half), 0, nullptr, nullptr);
+        if (!complex_config) throw std::bad_alloc();
+
+        // same phases (and float rounding) as kiss_fftr_alloc
+        super_twiddles.resize(half / 2);
+        for (uint32_t i = 0; i < half / 2; ++i) {
+            double phase = -3.14159265358979323846264338327 * ((double) (i + 1) / half + .5);
+            super_twiddles[i].r = (kiss_fft_scalar) std::cos(phase);
+            super_twiddles[i].i = (kiss_fft_scalar) std::sin(phase);
+        }
+    }
+
+    ~KissTables() {
+        kiss_fft_free(complex_config);
+    }
+
+    KissTables(const KissTables&) = delete;
+    KissTables& operator=(const KissTables&) = delete;
+};
+
+static SharedTableCache<uint32_t, KissTables> kiss_tables_cache;
+
+
+/**
+ * kissfft: portable, no planning cost, always available.
+ * - kiss_fftr's scheme (N/2 complex FFT of the even/odd samples, then a split pass)
+ *   with the twiddles shared through KissTables; the split pass below follows
+ *   kiss_fftr() operation for operation, so results are identical to it
+ */
+class KissFftBackend : public FftBackend {
+public:
+    explicit KissFftBackend(uint32_t size)
+        : FftBackend(size), in(size, 0.0f), packed(size / 2), out(size / 2 + 1) {
+        if (size < 4 || size % 2 != 0) throw std::invalid_argument("kissfft backend needs an even FFT size");
+        tables = kiss_tables_cache.acquire(size, [size] { return std::make_shared<const KissTables>(size); });
+    }
+
+    float* input() override { return in.data(); }
+    const float* output() const override { return reinterpret_cast<const float*>(out.data()); }
+    FftBackendKind kind() const override { return FftBackendKind::kiss; }
+
+    void execute() override {
+        const int ncfft = int(fft_size / 2);
+        kiss_fft(tables->complex_config, reinterpret_cast<const kiss_fft_cpx*>(in.data()), packed.data());
+
+        kiss_fft_cpx tdc = packed[0];
+        out[0].r = tdc.r + tdc.i;
+        out[ncfft].r = tdc.r - tdc.i;
+        out[ncfft].i = out[0].i = 0;
+
+        for (int k = 1; k <= ncfft / 2; ++k) {
+            kiss_fft_cpx fpk = packed[k];
+            kiss_fft_cpx fpnk = {packed[ncfft - k].r, -packed[ncfft - k].i};
+            const kiss_fft_cpx& w = tables->super_twiddles[k - 1];
+
+            kiss_fft_cpx f1k = {fpk.r + fpnk.r, fpk.i + fpnk.i};
+            kiss_fft_cpx f2k = {fpk.r - fpnk.r, fpk.i - fpnk.i};
+            kiss_fft_cpx tw = {f2k.r * w.r - f2k.i * w.i, f2k.r * w.i + f2k.i * w.r};
+
+            out[k].r = (f1k.r + tw.r) * 0.5f;
+            out[k].i = (f1k.i + tw.i) * 0.5f;
+            out[ncfft - k].r = (f1k.r - tw.r) * 0.5f;
+            out[ncfft - k].i = (tw.i - f1k.i) * 0.5f;
+        }
+    }
+
+private:
+    std::shared_ptr<const KissTables> tables;
+    std::vector<float> in;
+    std::vector<kiss_fft_cpx> packed;
+    std::vector<kiss_fft_cpx> out;
+};
+
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(float), "kiss_fft_cpx must be an interleaved float pair");
+
+
+#if defined(FFT_BACKEND_HAVE_FFTW)
+
+// the FFTW planner (and its wisdom) is global and not thread-safe, execution is
+static std::mutex fftw_planner_mutex;
+static std::string fftw_wisdom_file = default_fftw_wisdom_file();
+static bool fftw_wisdom_loaded = false;
+
+
+/**
+ * One FFTW_MEASURE plan per size, shared by every FftwBackend of that size.
+ * - wisdom is loaded from the wisdom file before the first plan; a size that is not
+ *   covered is measured once and the file is rewritten, so later runs start fast
+ * - planned on scratch buffers from fftwf_alloc, backends run it on their own
+ *   (equally aligned) buffers through the new-array execute interface
+ */
+struct FftwPlan {
+    fftwf_plan plan = nullptr;
+
+    explicit FftwPlan(uint32_t size) {
+        float* in = fftwf_alloc_real(size);
+        fftwf_complex* out = fftwf_alloc_complex(size / 2 + 1);
+
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        if (!fftw_wisdom_loaded) {
+            if (!fftw_wisdom_file.empty()) fftwf_import_wisdom_from_filename(fftw_wisdom_file.c_str());
+            fftw_wisdom_loaded = true;
+        }
+
+        plan = fftwf_plan_dft_r2c_1d(int(size), in, out, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        if (!plan) {
+            plan = fftwf_plan_dft_r2c_1d(int(size), in, out, FFTW_MEASURE);
+            if (!fftw_wisdom_file.empty()) {
+                std::error_code error;
+                std::filesystem::create_directories(std::filesystem::path(fftw_wisdom_file).parent_path(), error);
+                fftwf_export_wisdom_to_filename(fftw_wisdom_file.c_str());
+            }
+        }
+
+        fftwf_free(in);
+        fftwf_free(out);
+    }
+
+    ~FftwPlan() {
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+        fftwf_destroy_plan(plan);
+    }
+
+    FftwPlan(const FftwPlan&) = delete;
+    FftwPlan& operator=(const FftwPlan&) = delete;
+};
+
+static SharedTableCache<uint32_t, FftwPlan> fftw_plan_cache;
+
+
+class FftwBackend : public FftBackend {
+public:
+    explicit FftwBackend(uint32_t size) : FftBackend(size) {
+        shared_plan = fftw_plan_cache.acquire(size, [size] { return std::make_shared<const FftwPlan>(size); });
+        in = fftwf_alloc_real(size);
+        out = fftwf_alloc_complex(size / 2 + 1);
+        std::fill(in, in + size, 0.0f);
+    }
+
+    ~FftwBackend() override {
+        fftwf_free(in);
+        fftwf_free(out);
+    }
+
+    float* input() override { return in; }
+    const float* output() const override { return reinterpret_cast<const float*>(out); }
+    void execute() override { fftwf_execute_dft_r2c(shared_plan->plan, in, out); }
+    FftBackendKind kind() const override { return FftBackendKind::fftw; }
+
+private:
+    std::shared_ptr<const FftwPlan> shared_plan;
+    float* in = nullptr;
+    fftwf_complex* out = nullptr;
+};
+
+#endif
+
+
+/**
+ * Per-user wisdom location, independent of the working directory:
+ * $XDG_CACHE_HOME (else ~/.cache)/guitar_genre_guru/fftw_wisdom.dat; empty when
+ * neither is set.
+ */
+std::string default_fftw_wisdom_file() {
+    std::string base;
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache) {
+        base = cache;
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        base = std::string(home) + "/.cache";
+    } else {
+        return {};
+    }
+    return base + "/guitar_genre_guru/fftw_wisdom.dat";
+}
+
+
+/**
+ * Where FFTW wisdom is read from and written to (process-wide, FFTW wisdom is global).
+ * - takes effect for the first FFTW plan, call it before building extractors
+ * - an empty path keeps wisdom in memory only
+ */
+void set_fftw_wisdom_file(const std::string& path) {
+#if defined(FFT_BACKEND_HAVE_FFTW)
+    std::lock_guard<std::mutex> lock(fftw_planner_mutex);
+    fftw_wisdom_file = path;
+    fftw_wisdom_loaded = false;
+#else
+    (void)path;
+#endif
+}
+
+
+bool fft_backend_available(FftBackendKind kind) {
+    switch (kind) {
+        case FftBackendKind::automatic: return true;
+        case FftBackendKind::kiss: return true;
+        case FftBackendKind::fftw:
+#if defined(FFT_BACKEND_HAVE_FFTW)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+
+const char* fft_backend_name(FftBackendKind kind) {
+    switch (kind) {
+        case FftBackendKind::automatic: return "automatic";
+        case FftBackendKind::kiss: return "kissfft";
+        case FftBackendKind::fftw: return "fftw3";
+    }
+    return "unknown";
+}
+
+
+/**
+ * Build a backend for `size`.
+ * - `automatic` resolves to fastest_fft_backend(size)
+ * - an unavailable backend falls back to kissfft
+ */
+std::unique_ptr<FftBackend> make_fft_backend(FftBackendKind kind, uint32_t size) {
+    if (kind == FftBackendKind::automatic) kind = fastest_fft_backend(size);
+
+#if defined(FFT_BACKEND_HAVE_FFTW)
+    if (kind == FftBackendKind::fftw) return std::make_unique<FftwBackend>(size);
+#endif
+    return std::make_unique<KissFftBackend>(size);
+}
+
+
+/**
+ * Time every available backend on `size`, fastest first.
+ * - roughly 5 ms of transforms per backend after a warm-up, planning is not timed
+ */
+std::vector<FftBenchmarkResult> benchmark_fft_backends(uint32_t size) {
+    using clock = std::chrono::steady_clock;
+    std::vector<FftBenchmarkResult> results;
+
+    for (FftBackendKind kind : {FftBackendKind::kiss, FftBackendKind::fftw}) {
+        if (!fft_backend_available(kind)) continue;
+
+        std::unique_ptr<FftBackend> backend = make_fft_backend(kind, size);
+        float* input = backend->input();
+        for (uint32_t i = 0; i < size; ++i) {
+            input[i] = float(i % 17) - 8.0f;
+        }
+
+        for (int i = 0; i < 16; ++i) backend->execute();
+
+        size_t transforms = 0;
+        auto started = clock::now();
+        auto elapsed = clock::duration::zero();
+        while (elapsed < std::chrono::milliseconds(5)) {
+            for (int i = 0; i < 16; ++i) backend->execute();
+            transforms += 16;
+            elapsed = clock::now() - started;
+        }
+
+        FftBenchmarkResult result;
+        result.kind = kind;
+        result.ns_per_transform = std::chrono::duration<double, std::nano>(elapsed).count() / transforms;
+        results.push_back(result);
+    }
+
+    std::sort(results.begin(), results.end(), [](const FftBenchmarkResult& a, const FftBenchmarkResult& b) {
+        return a.ns_per_transform < b.ns_per_transform;
+    });
+    return results;
+}
+
+
+/**
+ * Fastest backend for `size` on this machine, benchmarked on first use per size.
+ */
+FftBackendKind fastest_fft_backend(uint32_t size) {
+    static std::mutex mutex;
+    static std::map<uint32_t, FftBackendKind> fastest;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = fastest.find(size);
+    if (it != fastest.end()) return it->second;
+
+    // with a single backend there is nothing to measure
+    FftBackendKind kind = FftBackendKind::kiss;
+    if (fft_backend_available(FftBackendKind::fftw)) {
+        kind = benchmark_fft_backends(size).front().kind;
+    }
+
+    fastest[size] = kind;
+    return kind;
+}
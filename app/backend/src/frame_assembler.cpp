@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "frame_assembler.hpp"
+
+
+/**
+ * Room for two frames, so a full frame can be read while the next hop is written.
+ */
+FrameAssembler::FrameAssembler(uint32_t frame, uint32_t hop) : frame_size(frame), hop_size(hop) {
+    capacity = std::bit_ceil(std::max<size_t>(2 * size_t(frame_size), 16));
+    mask = capacity - 1;
+    buffer.assign(2 * capacity, 0.0f);
+}
+
+
+/**
+ * Append samples, returns how many were accepted.
+ * - samples that fall into a gap skipped by a hop larger than the frame are
+ *   accepted and dropped
+ */
+size_t FrameAssembler::write(const float* input, size_t count) {
+    size_t accepted = 0;
+
+    if (read_pos > write_pos) {
+        size_t skip = size_t(std::min<uint64_t>(count, read_pos - write_pos));
+        write_pos += skip;
+        accepted += skip;
+    }
+
+    size_t n = std::min(count - accepted, writable());
+    const float* src = input + accepted;
+
+    // at most two runs around the end of the ring, each stored in both halves
+    while (n > 0) {
+        size_t index = size_t(write_pos & mask);
+        size_t run = std::min(n, capacity - index);
+
+        std::memcpy(buffer.data() + index, src, run * sizeof(float));
+        std::memcpy(buffer.data() + index + capacity, src, run * sizeof(float));
+
+        write_pos += run;
+        accepted += run;
+        src += run;
+        n -= run;
+    }
+
+    return accepted;
+}
+
+
+/**
+ * Grow so at least `samples` unread samples fit, keeping the buffered ones.
+ * - allocates, only needed when a caller stops draining frames mid-chunk
+ */
+void FrameAssembler::reserve(size_t samples) {
+    if (samples <= capacity) return;
+
+    size_t unread = buffered();
+    std::vector<float> pending(unread);
+    for (size_t i = 0; i < unread; ++i) {
+        pending[i] = buffer[size_t((read_pos + i) & mask)];
+    }
+
+    capacity = std::bit_ceil(samples);
+    mask = capacity - 1;
+    buffer.assign(2 * capacity, 0.0f);
+
+    // re-lay the unread samples at their new ring positions
+    uint64_t position = read_pos;
+    write_pos = read_pos;
+    write(pending.data(), unread);
+    read_pos = position;
+}
+
+
+bool FrameAssembler::has_frame() const {
+    return read_pos + frame_size <= write_pos;
+}
+
+
+/**
+ * Contiguous view of the current frame, valid until the next write().
+ */
+const float* FrameAssembler::frame() const {
+    return buffer.data() + size_t(read_pos & mask);
+}
+
+
+void FrameAssembler::advance() {
+    read_pos += hop_size;
+}
+
+
+size_t FrameAssembler::buffered() const {
+    return write_pos > read_pos ? size_t(write_pos - read_pos) : 0;
+}
+
+
+size_t FrameAssembler::writable() const {
+    return capacity - buffered();
+}
+
+
+/**
+ * Frames available once `more_samples` further samples have been written.
+ */
+size_t FrameAssembler::max_frames(size_t more_samples) const {
+    uint64_t end = write_pos + more_samples;
+    if (read_pos + frame_size > end) return 0;
+
+    return size_t((end - read_pos - frame_size) / hop_size + 1);
+}
+
+
+void FrameAssembler::reset() {
+    write_pos = 0;
+    read_pos = 0;
+}
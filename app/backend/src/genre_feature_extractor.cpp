@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "genre_feature_extractor.hpp"
+#include "simd_kernels.hpp"
+
+// onset_strength: lag 1, plus n_fft / (2 * hop) frames for the centred STFT
+static constexpr uint32_t ONSET_DELAY = 3;
+static constexpr uint32_t MEL_HISTORY = ONSET_DELAY + 1;
+
+// frame_values before the MFCCs: rms, centroid, bandwidth, rolloff, zcr
+static constexpr uint32_t SCALAR_FEATURES = 5;
+
+// frames the chroma tuning is estimated from before chroma statistics start
+static constexpr uint32_t TUNING_FRAMES = 128;
+
+
+FeatureExtractorConfig GenreFeatureExtractor::extractor_config(const GenreFeatureConfig& c) {
+    FeatureExtractorConfig fe;
+    fe.sample_rate = c.sample_rate;
+    fe.fft_size = c.n_fft;
+    fe.hop_size = c.hop_length;
+    fe.num_mels = c.n_mels;
+    fe.top_db = c.top_db;
+    fe.eps = c.amin;
+    fe.mel_scale = MelScale::slaney;
+    fe.periodic_window = true;
+    return fe;
+}
+
+
+static float periodic_hann_energy(uint32_t n) {
+    double sum = 0.0;
+    for (uint32_t i = 0; i < n; ++i) {
+        double w = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / n);
+        sum += w * w;
+    }
+    return float(sum);
+}
+
+
+GenreFeatureExtractor::GenreFeatureExtractor(const GenreFeatureConfig& c)
+    : config(c),
+      extractor(extractor_config(c)),
+      mfcc(MfccConfig{c.n_mels, c.n_mfcc}),
+      hpss(c.n_fft, periodic_hann_energy(c.n_fft), c.hpss_kernel),
+      tempo(TempoConfig{c.sample_rate, c.hop_length}),
+      assembler(c.n_fft, c.hop_length),
+      chroma(ChromaConfig{c.sample_rate, c.n_fft}),
+      tuning(c.sample_rate, c.n_fft),
+      frame_stats(SCALAR_FEATURES + c.n_mfcc),
+      chroma_stats(NUM_CHROMA),
+      hpss_stats(2) {
+    if (config.estimate_tuning) tuning_frames.resize(size_t(TUNING_FRAMES) * (config.n_fft / 2 + 1));
+    magnitude_scratch.resize(config.n_fft / 2 + 1);
+    padding.assign(config.n_fft / 2, 0.0f);
+    mel_history.resize(size_t(MEL_HISTORY) * config.n_mels);
+    mel_frame.resize(config.n_mels);
+    frame_values.resize(SCALAR_FEATURES + config.n_mfcc);
+    reset();
+}
+
+
+/**
+ * Start a new clip.
+ */
+void GenreFeatureExtractor::reset() {
+    assembler.reset();
+    hpss.reset();
+    tempo.reset();
+    tuning.reset();
+    tuning_settled = !config.estimate_tuning;
+    frame_stats.reset();
+    chroma_stats.reset();
+    hpss_stats.reset();
+
+    samples_in = 0;
+    frames = 0;
+    peak_db = 0.0f;
+    first_sample = last_sample = 0.0f;
+    finished = false;
+
+    // left half of the centred STFT's zero padding; never a whole frame on its own
+    write(padding.data(), padding.size());
+}
+
+
+/**
+ * Features of a whole clip of mono samples at config.sample_rate.
+ * - an empty clip gives all zeros
+ */
+GenreFeatures GenreFeatureExtractor::extract(const float* samples, size_t num_samples) {
+    reset();
+    push(samples, num_samples);
+    return finish();
+}
+
+
+/**
+ * Next chunk of the clip; every frame it completes goes straight into the statistics.
+ */
+void GenreFeatureExtractor::push(const float* samples, size_t num_samples) {
+    if (finished) throw std::logic_error("GenreFeatureExtractor::push after finish() needs reset()");
+    if (num_samples == 0) return;
+
+    if (samples_in == 0) first_sample = samples[0];
+    last_sample = samples[num_samples - 1];
+    samples_in += num_samples;
+    write(samples, num_samples);
+}
+
+
+void GenreFeatureExtractor::write(const float* samples, size_t num_samples) {
+    size_t offset = 0;
+    do {
+        offset += assembler.write(samples + offset, num_samples - offset);
+        while (assembler.has_frame()) {
+            process_frame(assembler.frame());
+            assembler.advance();
+        }
+    } while (offset < num_samples);
+}
+
+
+/**
+ * End of the clip: right-hand padding, the frames HPSS held back and the tempo
+ * tail; returns the clip's features. push() needs a reset() after this.
+ */
+GenreFeatures GenreFeatureExtractor::finish() {
+    if (!finished) {
+        finished = true;
+        if (samples_in > 0) {
+            write(padding.data(), padding.size());
+            if (!tuning_settled) settle_tuning(frames);
+
+            HpssFrameRms components;
+            while (hpss.flush(components)) {
+                float values[2] = {components.harmonic, components.percussive};
+                hpss_stats.push(values);
+            }
+            tempo.finish();
+        }
+    }
+    return snapshot();
+}
+
+
+/**
+ * Frames of the centred STFT over `num_samples` samples.
+ */
+size_t GenreFeatureExtractor::frame_count(size_t num_samples) const {
+    return num_samples == 0 ? 0 : 1 + num_samples / config.hop_length;
+}
+
+
+uint64_t GenreFeatureExtractor::frames_processed() const {
+    return frames;
+}
+
+
+/**
+ * librosa.feature.zero_crossing_rate of the current frame: the signal is edge-padded
+ * (the STFT frame is zero-padded), |x| <= 1e-10 counts as zero and zero as positive.
+ */
+float GenreFeatureExtractor::zero_crossing_rate(const float* frame) const {
+    const int64_t start = int64_t(frames * config.hop_length) - int64_t(config.n_fft / 2);
+    const int64_t end = int64_t(samples_in);
+
+    uint32_t crossings = 0;
+    bool previous = false;
+    for (uint32_t i = 0; i < config.n_fft; ++i) {
+        int64_t position = start + i;
+        float x = position < 0 ? first_sample : position >= end ? last_sample : frame[i];
+        bool negative = x < -1e-10f;
+        if (i > 0 && negative != previous) ++crossings;
+        previous = negative;
+    }
+    return float(crossings) / config.n_fft;
+}
+
+
+/**
+ * Every per-frame feature of one centred STFT frame, pushed into the statistics.
+ */
+void GenreFeatureExtractor::process_frame(const float* frame) {
+    const uint32_t n_fft = config.n_fft;
+    const uint32_t bins = n_fft / 2 + 1;
+    const uint32_t mels = config.n_mels;
+    float* values = frame_values.data();
+
+    values[0] = std::sqrt(simd::dot(frame, frame, n_fft) / n_fft);
+    values[4] = zero_crossing_rate(frame);
+
+    std::span<const float> power = extractor.compute_power_spectrum(frame);
+
+    SpectralDescriptors descriptors = compute_spectral_descriptors(power.data(), extractor.bin_frequencies().data(), bins,
+                                                                   magnitude_scratch.data());
+    values[1] = descriptors.centroid;
+    values[2] = descriptors.bandwidth;
+    values[3] = descriptors.rolloff;
+
+    if (tuning_settled) {
+        float pitch[NUM_CHROMA];
+        chroma.compute(power.data(), pitch);
+        chroma_stats.push(pitch);
+    } else {
+        tuning.push(power.data());
+        std::copy(power.begin(), power.end(), tuning_frames.begin() + frames * bins);
+        if (frames + 1 == TUNING_FRAMES) settle_tuning(TUNING_FRAMES);
+    }
+
+    // power_to_db(ref=1.0, amin, top_db), floored top_db below the loudest frame so far
+    float* db = mel_history.data() + (frames % MEL_HISTORY) * mels;
+    extractor.project_mel_power(power.data(), db);
+    float frame_peak = simd::power_to_db(db, mels, config.amin, db);
+    peak_db = frames == 0 ? frame_peak : std::max(peak_db, frame_peak);
+    const float floor_db = peak_db - config.top_db;
+
+    for (uint32_t m = 0; m < mels; ++m) mel_frame[m] = std::max(db[m], floor_db);
+    mfcc.compute(mel_frame.data(), values + SCALAR_FEATURES);
+    frame_stats.push(values);
+
+    // onset_strength: mean positive log-mel flux, delayed by ONSET_DELAY frames
+    float onset = 0.0f;
+    if (frames >= ONSET_DELAY) {
+        const float* current = mel_history.data() + ((frames - ONSET_DELAY + 1) % MEL_HISTORY) * mels;
+        const float* previous = mel_history.data() + ((frames - ONSET_DELAY) % MEL_HISTORY) * mels;
+        for (uint32_t m = 0; m < mels; ++m) {
+            onset += std::max(std::max(current[m], floor_db) - std::max(previous[m], floor_db), 0.0f);
+        }
+        onset /= mels;
+    }
+    tempo.push(onset);
+
+    HpssFrameRms components;
+    if (hpss.push(power.data(), components)) {
+        float rms[2] = {components.harmonic, components.percussive};
+        hpss_stats.push(rms);
+    }
+
+    ++frames;
+}
+
+
+/**
+ * Fix the chroma tuning and replay the `buffered` frames held for its estimate.
+ */
+void GenreFeatureExtractor::settle_tuning(size_t buffered) {
+    const size_t bins = config.n_fft / 2 + 1;
+    chroma.set_tuning(tuning.estimate());
+
+    float pitch[NUM_CHROMA];
+    for (size_t i = 0; i < buffered; ++i) {
+        chroma.compute(tuning_frames.data() + i * bins, pitch);
+        chroma_stats.push(pitch);
+    }
+    tuning_settled = true;
+}
+
+
+/**
+ * Features of the frames complete so far, without ending the clip.
+ * - frames still held back by HPSS and the tempo window's tail only count after
+ *   finish()
+ * - before the tuning is settled, chroma uses the estimate so far
+ */
+GenreFeatures GenreFeatureExtractor::snapshot() const {
+    GenreFeatures features;
+    if (frames == 0) return features;
+
+    float* out = features.values.data();
+    if (tuning_settled) {
+        chroma_stats.pooled(out[0], out[1]);
+    } else {
+        ChromaConfig chroma_config = chroma.get_config();
+        chroma_config.tuning = tuning.estimate();
+        ChromaExtractor provisional(chroma_config);
+        RunningStats pending(NUM_CHROMA);
+        float pitch[NUM_CHROMA];
+        for (size_t i = 0; i < frames; ++i) {
+            provisional.compute(tuning_frames.data() + i * (config.n_fft / 2 + 1), pitch);
+            pending.push(pitch);
+        }
+        pending.pooled(out[0], out[1]);
+    }
+
+    std::span<const double> means = frame_stats.mean();
+    for (uint32_t i = 0; i < SCALAR_FEATURES; ++i) {
+        out[2 + 2 * i] = float(means[i]);
+        out[3 + 2 * i] = float(frame_stats.variance(i));
+    }
+
+    std::span<const double> components = hpss_stats.mean();
+    out[12] = float(components[0]);
+    out[13] = float(hpss_stats.variance(0));
+    out[14] = float(components[1]);
+    out[15] = float(hpss_stats.variance(1));
+
+    out[16] = tempo.estimate();
+
+    for (uint32_t k = 0; k < config.n_mfcc && 18 + 2 * k < GENRE_FEATURE_COUNT; ++k) {
+        out[17 + 2 * k] = float(means[SCALAR_FEATURES + k]);
+        out[18 + 2 * k] = float(frame_stats.variance(SCALAR_FEATURES + k));
+    }
+    return features;
+}
+
+
+const GenreFeatureConfig& GenreFeatureExtractor::get_config() const {
+    return config;
+}
+
+
+/**
+ * Values in CSV column order, as FeatureWriter::write_row takes them.
+ */
+std::vector<float> GenreFeatures::to_row() const {
+    return std::vector<float>(values.begin(), values.end());
+}
+
+
+/**
+ * Header names of data/audio_features.csv for the 57 values.
+ */
+const std::array<std::string, GENRE_FEATURE_COUNT>& GenreFeatures::column_names() {
+    static const std::array<std::string, GENRE_FEATURE_COUNT> names = [] {
+        std::array<std::string, GENRE_FEATURE_COUNT> n;
+        const char* pairs[] = {"chroma_stft", "rms", "spectral_centroid", "spectral_bandwidth", "rolloff",
+                               "zero_crossing_rate", "harmony", "perceptr"};
+        size_t i = 0;
+        for (const char* base : pairs) {
+            n[i++] = std::string(base) + "_mean";
+            n[i++] = std::string(base) + "_var";
+        }
+        n[i++] = "tempo";
+        for (int k = 1; i < GENRE_FEATURE_COUNT; ++k) {
+            n[i++] = "mfcc" + std::to_string(k) + "_mean";
+            n[i++] = "mfcc" + std::to_string(k) + "_var";
+        }
+        return n;
+    }();
+    return names;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "hpss.hpp"
+
+
+MedianHpss::MedianHpss(uint32_t size, float window_power_sum, uint32_t kernel_size)
+    : fft_size(size), bins(size / 2 + 1), kernel(kernel_size), half(kernel_size / 2) {
+    if (size == 0 || size % 2 != 0) throw std::invalid_argument("HPSS needs an even FFT size");
+    if (kernel_size == 0 || kernel_size % 2 == 0) throw std::invalid_argument("HPSS kernel size must be odd");
+    if (!(window_power_sum > 0.0f)) throw std::invalid_argument("HPSS needs the window energy");
+
+    rms_scale = 1.0f / (float(size) * window_power_sum);
+    history.resize(size_t(kernel + 1) * bins);
+    sorted_time.resize(size_t(kernel) * bins);
+    harmonic.resize(bins);
+    window_values.resize(kernel);
+    sorted_bins.resize(kernel);
+}
+
+
+// scipy.ndimage "reflect": (d c b a | a b c d | d c b a)
+static int64_t reflect(int64_t i, int64_t n) {
+    while (i < 0 || i >= n) {
+        i = i < 0 ? -i - 1 : 2 * n - i - 1;
+    }
+    return i;
+}
+
+
+static float median(float* values, size_t n) {
+    std::nth_element(values, values + n / 2, values + n);
+    return values[n / 2];
+}
+
+
+// swap `old_value` for `new_value` in a sorted window, keeping it sorted
+static void replace_sorted(float* sorted, size_t n, float old_value, float new_value) {
+    size_t i = size_t(std::lower_bound(sorted, sorted + n, old_value) - sorted);
+    if (new_value > old_value) {
+        while (i + 1 < n && sorted[i + 1] < new_value) {
+            sorted[i] = sorted[i + 1];
+            ++i;
+        }
+    } else {
+        while (i > 0 && sorted[i - 1] > new_value) {
+            sorted[i] = sorted[i - 1];
+            --i;
+        }
+    }
+    sorted[i] = new_value;
+}
+
+
+const float* MedianHpss::magnitudes(uint64_t frame) const {
+    return history.data() + (frame % (kernel + 1)) * bins;
+}
+
+
+/**
+ * Add the power spectrum of the next frame (`fft_size / 2 + 1` bins).
+ * - returns true and fills `out` once frame latency_frames() back is complete
+ */
+bool MedianHpss::push(const float* power, HpssFrameRms& out) {
+    float* slot = history.data() + (frames_in % (kernel + 1)) * bins;
+    for (uint32_t k = 0; k < bins; ++k) {
+        slot[k] = std::sqrt(power[k]);
+    }
+    ++frames_in;
+
+    if (frames_in <= half) return false;
+
+    // the stream length is still unknown, but the window only reaches frames_in - 1
+    emit(frames_emitted, UINT64_MAX, out);
+    ++frames_emitted;
+    return true;
+}
+
+
+/**
+ * Emit the frames still held back after the last push(), one per call.
+ * - returns false once every frame pushed has been emitted
+ */
+bool MedianHpss::flush(HpssFrameRms& out) {
+    if (frames_emitted >= frames_in) return false;
+
+    emit(frames_emitted, frames_in, out);
+    ++frames_emitted;
+    return true;
+}
+
+
+void MedianHpss::reset() {
+    frames_in = 0;
+    frames_emitted = 0;
+    sorted_valid = false;
+}
+
+
+uint32_t MedianHpss::latency_frames() const {
+    return half;
+}
+
+
+/**
+ * Masks and component energies of `frame` in a stream of `total` frames.
+ */
+void MedianHpss::emit(uint64_t frame, uint64_t total, HpssFrameRms& out) {
+    const int64_t length = int64_t(std::min<uint64_t>(total, frames_in));
+
+    // harmonic: along time; interior frames slide the previous frame's sorted windows
+    const bool interior = frame >= half && int64_t(frame + half) < length;
+    if (interior && sorted_valid && sorted_frame + 1 == frame) {
+        const float* leaving = magnitudes(frame - half - 1);
+        const float* entering = magnitudes(frame + half);
+        for (uint32_t k = 0; k < bins; ++k) {
+            float* sorted = sorted_time.data() + size_t(k) * kernel;
+            replace_sorted(sorted, kernel, leaving[k], entering[k]);
+            harmonic[k] = sorted[half];
+        }
+    } else if (interior) {
+        for (uint32_t k = 0; k < bins; ++k) {
+            float* sorted = sorted_time.data() + size_t(k) * kernel;
+            for (uint32_t j = 0; j < kernel; ++j) sorted[j] = magnitudes(frame - half + j)[k];
+            std::sort(sorted, sorted + kernel);
+            harmonic[k] = sorted[half];
+        }
+    } else {
+        for (uint32_t k = 0; k < bins; ++k) {
+            for (uint32_t j = 0; j < kernel; ++j) {
+                int64_t source = reflect(int64_t(frame) + int64_t(j) - int64_t(half), length);
+                window_values[j] = magnitudes(uint64_t(source))[k];
+            }
+            harmonic[k] = median(window_values.data(), kernel);
+        }
+    }
+    sorted_valid = interior;
+    sorted_frame = frame;
+
+    // percussive: along frequency, then both masks in the same pass
+    const float* current = magnitudes(frame);
+    double harmonic_energy = 0.0;
+    double percussive_energy = 0.0;
+
+    for (uint32_t k = 0; k < bins; ++k) {
+        float percussive;
+        if (k < half || k + half >= bins) {
+            for (uint32_t j = 0; j < kernel; ++j) {
+                window_values[j] = current[reflect(int64_t(k) + int64_t(j) - int64_t(half), bins)];
+            }
+            percussive = median(window_values.data(), kernel);
+        } else {
+            if (k == half) {
+                std::copy(current, current + kernel, sorted_bins.begin());
+                std::sort(sorted_bins.begin(), sorted_bins.end());
+            } else {
+                replace_sorted(sorted_bins.data(), kernel, current[k - half - 1], current[k + half]);
+            }
+            percussive = sorted_bins[half];
+        }
+
+        float h2 = harmonic[k] * harmonic[k];
+        float p2 = percussive * percussive;
+        float total_power = h2 + p2;
+        if (total_power <= 0.0f) continue;     // librosa's softmask gives both masks 0 here
+
+        // both edge bins appear once in the full spectrum, every other bin twice
+        float weight = (k == 0 || k == bins - 1) ? 1.0f : 2.0f;
+        float power = current[k] * current[k];
+        float mask_h = h2 / total_power;
+        float mask_p = p2 / total_power;
+        harmonic_energy += weight * power * mask_h * mask_h;
+        percussive_energy += weight * power * mask_p * mask_p;
+    }
+
+    out.harmonic = std::sqrt(float(harmonic_energy) * rms_scale);
+    out.percussive = std::sqrt(float(percussive_energy) * rms_scale);
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstring>
+
+#include "librosa_mel_spectrogram.hpp"
+#include "simd_kernels.hpp"
+
+
+FeatureExtractorConfig LibrosaMelSpectrogram::extractor_config(const LibrosaMelConfig& c) {
+    FeatureExtractorConfig fe;
+    fe.sample_rate = c.sample_rate;
+    fe.fft_size = c.n_fft;
+    fe.hop_size = c.hop_length;
+    fe.num_mels = c.n_mels;
+    fe.fmin = c.fmin;
+    fe.fmax = c.fmax;
+    fe.top_db = c.top_db;
+    fe.eps = c.amin;
+    fe.mel_scale = MelScale::slaney;
+    fe.periodic_window = true;
+    return fe;
+}
+
+
+LibrosaMelSpectrogram::LibrosaMelSpectrogram(const LibrosaMelConfig& c)
+    : config(c), extractor(extractor_config(c)) {
+    if (config.fmax < 0.0f) config.fmax = 0.5f * config.sample_rate;
+}
+
+
+/**
+ * Frames librosa produces for `num_samples` samples.
+ */
+size_t LibrosaMelSpectrogram::frame_count(size_t num_samples) const {
+    if (config.center) return 1 + num_samples / config.hop_length;
+    if (num_samples < config.n_fft) return 0;
+    return 1 + (num_samples - config.n_fft) / config.hop_length;
+}
+
+
+/**
+ * Log-mel spectrogram of the whole signal.
+ */
+FeatureMatrix LibrosaMelSpectrogram::compute(const float* signal, size_t num_samples) {
+    FeatureMatrix matrix;
+    matrix.frames = frame_count(num_samples);
+    matrix.num_mels = config.n_mels;
+    matrix.data.resize(matrix.frames * config.n_mels);
+    if (matrix.frames == 0) return matrix;
+
+    const float* source = signal;
+    if (config.center) {
+        const size_t pad = config.n_fft / 2;
+        padded.assign(num_samples + 2 * pad, 0.0f);
+        std::memcpy(padded.data() + pad, signal, num_samples * sizeof(float));
+        source = padded.data();
+    }
+
+    for (size_t frame = 0; frame < matrix.frames; ++frame) {
+        extractor.compute_mel_power(source + frame * config.hop_length, matrix.data.data() + frame * config.n_mels);
+    }
+
+    // power_to_db(ref=np.max): 10 log10(max(amin, S)) - 10 log10(max(amin, max S)),
+    // then floored at top_db below the peak; the kernel's S + amin only differs from
+    // max(amin, S) within a few amin of the floor, far under top_db of any real signal
+    float max_db = simd::power_to_db(matrix.data.data(), matrix.data.size(), config.amin, matrix.data.data());
+    float floor_db = -config.top_db;
+    for (float& value : matrix.data) {
+        value = std::max(value - max_db, floor_db);
+    }
+
+    return matrix;
+}
+
+
+const LibrosaMelConfig& LibrosaMelSpectrogram::get_config() const {
+    return config;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+
+#include "mel_filterbank.hpp"
+#include "simd_kernels.hpp"
+
+
+static float hz_to_mel(float hz) {
+    return 2595.0f * std::log10(1.0f + hz / 700.0f);
+}
+
+static float mel_to_hz(float mel) {
+    return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+
+// Slaney's auditory-toolbox scale as in librosa: linear below 1 kHz, log above
+static constexpr double SLANEY_HZ_PER_MEL = 200.0 / 3.0;
+static constexpr double SLANEY_MIN_LOG_HZ = 1000.0;
+static constexpr double SLANEY_MIN_LOG_MEL = SLANEY_MIN_LOG_HZ / SLANEY_HZ_PER_MEL;
+static const double SLANEY_LOG_STEP = std::log(6.4) / 27.0;
+
+static double slaney_hz_to_mel(double hz) {
+    if (hz < SLANEY_MIN_LOG_HZ) return hz / SLANEY_HZ_PER_MEL;
+    return SLANEY_MIN_LOG_MEL + std::log(hz / SLANEY_MIN_LOG_HZ) / SLANEY_LOG_STEP;
+}
+
+static double slaney_mel_to_hz(double mel) {
+    if (mel < SLANEY_MIN_LOG_MEL) return mel * SLANEY_HZ_PER_MEL;
+    return SLANEY_MIN_LOG_HZ * std::exp(SLANEY_LOG_STEP * (mel - SLANEY_MIN_LOG_MEL));
+}
+
+
+/**
+ * Keep the non-zero span of one dense filter row.
+ */
+static void append_band(MelFilterbank& bank, MelBand& band, const std::vector<float>& filter) {
+    const size_t num_bins = filter.size();
+
+    size_t first = 0;
+    while (first < num_bins && filter[first] == 0.0f) ++first;
+    size_t last = num_bins;
+    while (last > first && filter[last - 1] == 0.0f) --last;
+
+    band.start = uint32_t(first);
+    band.length = uint32_t(last - first);
+    band.offset = uint32_t(bank.weights.size());
+    bank.weights.insert(bank.weights.end(), filter.begin() + first, filter.begin() + last);
+}
+
+
+/**
+ * librosa.filters.mel(htk=False, norm="slaney"), computed in double like numpy.
+ * - band edges are exact frequencies, each triangle is evaluated at every bin
+ *   centre frequency and scaled by 2 / (upper edge - lower edge)
+ */
+static MelFilterbank build_slaney_filterbank(uint32_t sample_rate, uint32_t fft_size, uint32_t num_mels, float fmin, float fmax) {
+    const size_t num_bins = fft_size / 2 + 1;
+
+    MelFilterbank bank;
+    bank.bands.assign(num_mels, MelBand{});
+
+    double mel_min = slaney_hz_to_mel(fmin);
+    double mel_max = slaney_hz_to_mel(fmax);
+
+    std::vector<double> edges(num_mels + 2);
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        edges[i] = slaney_mel_to_hz(mel_min + (mel_max - mel_min) * i / (num_mels + 1));
+    }
+
+    std::vector<float> filter(num_bins);
+
+    for (uint32_t m = 0; m < num_mels; ++m) {
+        double lower_width = edges[m + 1] - edges[m];
+        double upper_width = edges[m + 2] - edges[m + 1];
+        double norm = 2.0 / (edges[m + 2] - edges[m]);
+
+        for (size_t k = 0; k < num_bins; ++k) {
+            double hz = double(k) * sample_rate / fft_size;
+            double rising = (hz - edges[m]) / lower_width;
+            double falling = (edges[m + 2] - hz) / upper_width;
+            filter[k] = float(std::max(0.0, std::min(rising, falling)) * norm);
+        }
+
+        append_band(bank, bank.bands[m], filter);
+    }
+
+    return bank;
+}
+
+
+/**
+ * Mel power of every band from one power spectrum, `bands.size()` values.
+ */
+void MelFilterbank::project(const float* power, float* mel_power) const {
+    for (size_t m = 0; m < bands.size(); ++m) {
+        const MelBand& band = bands[m];
+        mel_power[m] = simd::dot(power + band.start, weights.data() + band.offset, band.length);
+    }
+}
+
+
+/**
+ * Triangular mel filters between fmin and fmax.
+ * - htk: on the bin grid, each normalised to unit area (the original extractor)
+ * - slaney: librosa's filterbank, see build_slaney_filterbank
+ */
+MelFilterbank build_mel_filterbank(uint32_t sample_rate, uint32_t fft_size, uint32_t num_mels, float fmin, float fmax,
+                                   MelScale scale) {
+    if (scale == MelScale::slaney) return build_slaney_filterbank(sample_rate, fft_size, num_mels, fmin, fmax);
+
+    const size_t num_bins = fft_size / 2 + 1;
+
+    MelFilterbank bank;
+    bank.bands.assign(num_mels, MelBand{});
+
+    float mel_min = hz_to_mel(fmin);
+    float mel_max = hz_to_mel(fmax);
+
+    std::vector<float> mel_points(num_mels + 2);
+    std::vector<int> bin_points(num_mels + 2);
+
+    int max_bin = fft_size / 2;
+
+    for (uint32_t i = 0; i < mel_points.size(); ++i) {
+        mel_points[i] = mel_min + (mel_max - mel_min) * i / (num_mels + 1);
+
+        float hz = mel_to_hz(mel_points[i]);
+        bin_points[i] = std::min(max_bin, int(std::floor((fft_size + 1) * hz / sample_rate)));
+    }
+
+    std::vector<float> filter(num_bins);
+
+    for (uint32_t m = 1; m <= num_mels; ++m) {
+        std::fill(filter.begin(), filter.end(), 0.0f);
+
+        for (int k = bin_points[m - 1]; k < bin_points[m]; ++k) {
+            filter[k] = float(k - bin_points[m - 1]) / (bin_points[m] - bin_points[m - 1]);
+        }
+
+        for (int k = bin_points[m]; k < bin_points[m + 1]; ++k) {
+            filter[k] = float(bin_points[m + 1] - k) / (bin_points[m + 1] - bin_points[m]);
+        }
+
+        float sum = 0.0f;
+        for (float v : filter) {
+            sum += v;
+        }
+        if (sum > 0.0f) {
+            for (float& v : filter) {
+                v /= sum;
+            }
+        }
+
+        append_band(bank, bank.bands[m - 1], filter);
+    }
+
+    return bank;
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "mfcc.hpp"
+#include "simd_kernels.hpp"
+
+
+MfccStage::MfccStage(const MfccConfig& c) : config(c) {
+    if (config.num_mels == 0 || config.num_coefficients == 0 || config.num_coefficients > config.num_mels) {
+        throw std::invalid_argument("MFCC needs 1 <= num_coefficients <= num_mels");
+    }
+    if (config.deltas && (config.delta_width < 3 || config.delta_width % 2 == 0)) {
+        throw std::invalid_argument("delta_width must be odd and at least 3");
+    }
+
+    const uint32_t mels = config.num_mels;
+    const uint32_t coeffs = config.num_coefficients;
+
+    dct.resize(size_t(coeffs) * mels);
+    for (uint32_t k = 0; k < coeffs; ++k) {
+        double scale = std::sqrt((k == 0 ? 1.0 : 2.0) / mels);
+        if (config.lifter > 0.0f) {
+            scale *= 1.0 + 0.5 * config.lifter * std::sin(M_PI * (k + 1) / config.lifter);
+        }
+        for (uint32_t m = 0; m < mels; ++m) {
+            dct[size_t(k) * mels + m] = float(scale * std::cos(M_PI * k * (m + 0.5) / mels));
+        }
+    }
+
+    if (!config.deltas) return;
+
+    // least-squares derivatives over n = -N..N: the linear fit's slope and twice the
+    // quadratic fit's curvature (savgol_filter with deriv = polyorder = 1 and 2)
+    half_width = config.delta_width / 2;
+    const double n_count = config.delta_width;
+    double sum_n2 = 0.0;
+    for (int n = -int(half_width); n <= int(half_width); ++n) sum_n2 += double(n) * n;
+    const double mean_n2 = sum_n2 / n_count;
+    double sum_centered = 0.0;
+    for (int n = -int(half_width); n <= int(half_width); ++n) sum_centered += (double(n) * n - mean_n2) * (double(n) * n - mean_n2);
+
+    delta_weights.resize(config.delta_width);
+    delta2_weights.resize(config.delta_width);
+    for (int n = -int(half_width); n <= int(half_width); ++n) {
+        delta_weights[n + half_width] = float(n / sum_n2);
+        delta2_weights[n + half_width] = float(2.0 * (double(n) * n - mean_n2) / sum_centered);
+    }
+
+    history_frames = config.delta_width + half_width;
+    history.resize(size_t(history_frames) * coeffs);
+}
+
+
+/**
+ * Cepstrum of one log-mel frame, num_coefficients values (no deltas).
+ */
+void MfccStage::compute(const float* log_mel, float* cepstrum) const {
+    const uint32_t mels = config.num_mels;
+    for (uint32_t k = 0; k < config.num_coefficients; ++k) {
+        cepstrum[k] = simd::dot(dct.data() + size_t(k) * mels, log_mel, mels);
+    }
+}
+
+
+/**
+ * Feed one log-mel frame; returns true when a frame_size() frame was written to `out`.
+ * - without deltas every call emits the frame just pushed
+ * - with deltas the frame emitted is latency_frames() behind the input
+ */
+bool MfccStage::push(const float* log_mel, float* out) {
+    if (!config.deltas) {
+        compute(log_mel, out);
+        return true;
+    }
+
+    compute(log_mel, history.data() + size_t(frames_pushed % history_frames) * config.num_coefficients);
+    ++frames_pushed;
+    if (frames_pushed < config.delta_width) return false;
+
+    emit(frames_emitted++, out);
+    return true;
+}
+
+
+/**
+ * Emit the frames still held back by the delta window, one per call. Returns false
+ * when nothing is left; reset() before starting another stream.
+ */
+bool MfccStage::flush(float* out) {
+    if (!config.deltas || frames_emitted == frames_pushed) return false;
+
+    emit(frames_emitted++, out);
+    return true;
+}
+
+
+/**
+ * Write `frame` with its deltas.
+ * - the deltas come from the window centred on `frame`, clamped to the first / last
+ *   full window at the stream edges: the fit has degree = derivative order, so its
+ *   derivative is the same everywhere in the window (savgol_filter mode="interp")
+ */
+void MfccStage::emit(uint64_t frame, float* out) const {
+    const uint32_t coeffs = config.num_coefficients;
+    auto cepstrum = [&](uint64_t t) { return history.data() + size_t(t % history_frames) * coeffs; };
+
+    std::memcpy(out, cepstrum(frame), coeffs * sizeof(float));
+
+    float* delta = out + coeffs;
+    float* delta2 = out + 2 * coeffs;
+    std::fill(delta, delta + 2 * coeffs, 0.0f);
+    if (frames_pushed < config.delta_width) return;
+
+    const uint64_t centre = std::clamp<uint64_t>(frame, half_width, frames_pushed - 1 - half_width);
+    for (uint32_t i = 0; i < config.delta_width; ++i) {
+        const float* window_frame = cepstrum(centre - half_width + i);
+        const float w1 = delta_weights[i];
+        const float w2 = delta2_weights[i];
+        for (uint32_t k = 0; k < coeffs; ++k) {
+            delta[k] += w1 * window_frame[k];
+            delta2[k] += w2 * window_frame[k];
+        }
+    }
+}
+
+
+void MfccStage::reset() {
+    frames_pushed = 0;
+    frames_emitted = 0;
+}
+
+
+uint32_t MfccStage::frame_size() const {
+    return config.deltas ? 3 * config.num_coefficients : config.num_coefficients;
+}
+
+
+uint32_t MfccStage::latency_frames() const {
+    return 2 * half_width;
+}
+
+
+const MfccConfig& MfccStage::get_config() const {
+    return config;
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+
+#include "offline_feature_extractor.hpp"
+
+
+static constexpr size_t FRAMES_PER_BLOCK = 64;    // small enough to balance, large enough to amortise the claim
+
+
+std::span<const float> FeatureMatrix::row(size_t frame) const {
+    return std::span<const float>(data.data() + frame * num_mels, num_mels);
+}
+
+
+/**
+ * One extractor per pool thread, built up front so process() never allocates plans
+ * (apart from each worker's 4-wide FFT, set up by its first batch).
+ */
+OfflineFeatureExtractor::OfflineFeatureExtractor(const FeatureExtractorConfig& c, size_t thread_count)
+    : config(c), pool(thread_count) {
+    extractors.reserve(pool.size());
+    for (size_t i = 0; i < pool.size(); ++i) {
+        extractors.push_back(std::make_unique<FeatureExtractor>(config));
+    }
+}
+
+
+size_t OfflineFeatureExtractor::thread_count() const {
+    return pool.size();
+}
+
+
+/**
+ * Frames a one-shot serial pass over `num_samples` samples produces.
+ */
+size_t OfflineFeatureExtractor::frame_count(const FeatureExtractorConfig& config, size_t num_samples) {
+    if (num_samples < config.fft_size) return 0;
+    return (num_samples - config.fft_size) / config.hop_size + 1;
+}
+
+
+/**
+ * Extract every frame of `signal`.
+ * - blocks until all workers are done, the signal must stay alive for the call
+ */
+FeatureMatrix OfflineFeatureExtractor::process(const float* signal, size_t num_samples) {
+    FeatureMatrix matrix;
+    matrix.frames = frame_count(config, num_samples);
+    matrix.num_mels = config.num_mels;
+    matrix.data.resize(matrix.frames * config.num_mels);
+
+    const size_t blocks = (matrix.frames + FRAMES_PER_BLOCK - 1) / FRAMES_PER_BLOCK;
+    std::atomic<size_t> next_block{0};
+
+    const size_t workers = std::min(extractors.size(), blocks);
+    for (size_t w = 0; w < workers; ++w) {
+        pool.submit([&, w] {
+            FeatureExtractor& extractor = *extractors[w];
+
+            for (size_t block = next_block.fetch_add(1); block < blocks; block = next_block.fetch_add(1)) {
+                size_t first = block * FRAMES_PER_BLOCK;
+                size_t last = std::min(first + FRAMES_PER_BLOCK, matrix.frames);
+
+                // four hops per 4-wide FFT pass, the block tail one at a time
+                size_t frame = first;
+                for (; frame + BATCH_FFT_LANES <= last; frame += BATCH_FFT_LANES) {
+                    const float* frames[BATCH_FFT_LANES];
+                    float* rows[BATCH_FFT_LANES];
+                    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+                        frames[lane] = signal + (frame + lane) * config.hop_size;
+                        rows[lane] = matrix.data.data() + (frame + lane) * config.num_mels;
+                    }
+                    extractor.compute_frames4(frames, rows);
+                }
+                for (; frame < last; ++frame) {
+                    extractor.compute_frame(signal + frame * config.hop_size, matrix.data.data() + frame * config.num_mels);
+                }
+            }
+        });
+    }
+
+    pool.wait_idle();
+    return matrix;
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "resampler.hpp"
+#include "simd_kernels.hpp"
+
+
+/**
+ * Zeroth-order modified Bessel function of the first kind (power series).
+ */
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double half_x = 0.5 * x;
+
+    for (int k = 1; k < 64; ++k) {
+        term *= (half_x / k) * (half_x / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+
+/**
+ * Stopband attenuation (dB) of a Kaiser window with shape `beta`, inverting Kaiser's
+ * empirical beta(A) formula by bisection.
+ */
+static double kaiser_attenuation(double beta) {
+    auto beta_for = [](double a) {
+        if (a > 50.0) return 0.1102 * (a - 8.7);
+        if (a >= 21.0) return 0.5842 * std::pow(a - 21.0, 0.4) + 0.07886 * (a - 21.0);
+        return 0.0;
+    };
+
+    double lo = 21.0, hi = 300.0;
+    for (int i = 0; i < 60; ++i) {
+        double mid = 0.5 * (lo + hi);
+        (beta_for(mid) < beta ? lo : hi) = mid;
+    }
+    return lo;
+}
+
+
+/**
+ * Reduces the rate ratio and builds the polyphase filter bank.
+ * - throws std::invalid_argument on a zero rate or a ratio that needs more than
+ *   MAX_RESAMPLER_PHASES phases
+ */
+PolyphaseResampler::PolyphaseResampler(const ResamplerConfig& c) : config(c) {
+    if (config.input_rate == 0 || config.output_rate == 0 || config.taps_per_phase == 0) {
+        throw std::invalid_argument("resampler rates and tap count must be non-zero");
+    }
+
+    uint32_t divisor = std::gcd(config.input_rate, config.output_rate);
+    up = config.output_rate / divisor;
+    down = config.input_rate / divisor;
+
+    if (up > MAX_RESAMPLER_PHASES) {
+        throw std::invalid_argument("resampler ratio needs too many filter phases");
+    }
+
+    // one output step may advance the input by ceil(M / L) samples, the window must
+    // be at least that long so no input is skipped between calls
+    taps = std::max(config.taps_per_phase, (down + up - 1) / up);
+
+    build_filter_bank();
+    reset();
+}
+
+
+/**
+ * Prototype low-pass at the upsampled rate L * input_rate, split into L phases.
+ * - Kaiser's length formula gives the transition width the window reaches over the
+ *   prototype; the cutoff sits half of it below the lower of the two Nyquist
+ *   frequencies, so the stopband starts at that Nyquist
+ * - the prototype is scaled so every phase has unit DC gain on average
+ * - throws std::invalid_argument when taps_per_phase is too short for any passband
+ */
+void PolyphaseResampler::build_filter_bank() {
+    const size_t length = size_t(up) * taps;
+    const double center = 0.5 * (length - 1);
+    const double window_norm = bessel_i0(config.kaiser_beta);
+
+    // cycles per upsampled sample
+    const double nyquist = 0.5 / std::max(up, down);
+    const double transition = (kaiser_attenuation(config.kaiser_beta) - 7.95) / (2.285 * 2.0 * M_PI * std::max<double>(length - 1, 1));
+    const double cutoff = nyquist - 0.5 * transition;
+    if (cutoff <= 0.0) throw std::invalid_argument("taps_per_phase is too short for the resampler's transition band");
+
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+
+    for (size_t n = 0; n < length; ++n) {
+        double x = n - center;
+        double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * M_PI * cutoff * x) / (2.0 * M_PI * cutoff * x);
+
+        double r = length > 1 ? x / center : 0.0;
+        double window = bessel_i0(config.kaiser_beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / window_norm;
+
+        prototype[n] = 2.0 * cutoff * sinc * window;
+        sum += prototype[n];
+    }
+
+    filter_bank.assign(length, 0.0f);
+    for (uint32_t p = 0; p < up; ++p) {
+        float* phase_taps = filter_bank.data() + size_t(p) * taps;
+        for (uint32_t k = 0; k < taps; ++k) {
+            phase_taps[taps - 1 - k] = float(prototype[p + size_t(k) * up] * up / sum);
+        }
+    }
+}
+
+
+/**
+ * Clear the stream state, the next input is treated as the start of a new stream.
+ */
+void PolyphaseResampler::reset() {
+    history.assign(taps - 1, 0.0f);
+    phase = 0;
+}
+
+
+/**
+ * Resample one block into `output`.
+ * - `output` must hold at least max_output_frames(frames) samples
+ * - returns the number of samples written
+ */
+size_t PolyphaseResampler::process(const float* input, size_t frames, float* output) {
+    history.insert(history.end(), input, input + frames);
+
+    size_t count = 0;
+    size_t position = 0;
+
+    // output j sits at upsampled time j * M = position * L + phase
+    while (position + taps <= history.size()) {
+        output[count++] = simd::dot(filter_bank.data() + size_t(phase) * taps, history.data() + position, taps);
+
+        phase += down;
+        position += phase / up;
+        phase %= up;
+    }
+
+    history.erase(history.begin(), history.begin() + position);
+    return count;
+}
+
+
+/**
+ * Resample one block and append the result to `output`.
+ */
+size_t PolyphaseResampler::process(const float* input, size_t frames, std::vector<float>& output) {
+    size_t offset = output.size();
+    output.resize(offset + max_output_frames(frames));
+
+    size_t count = process(input, frames, output.data() + offset);
+    output.resize(offset + count);
+    return count;
+}
+
+
+/**
+ * End of stream: append the output still held in the filter, then reset().
+ * - feeds taps - 1 zeros, so the last input sample passes through every tap
+ * - returns the number of samples appended
+ */
+size_t PolyphaseResampler::flush(std::vector<float>& output) {
+    std::vector<float> zeros(taps - 1, 0.0f);
+    size_t count = process(zeros.data(), zeros.size(), output);
+    reset();
+    return count;
+}
+
+
+/**
+ * Upper bound on the samples the next process() call can produce.
+ */
+size_t PolyphaseResampler::max_output_frames(size_t input_frames) const {
+    return (history.size() + input_frames) * up / down + 1;
+}
+
+
+/**
+ * Group delay of the filter in output samples.
+ */
+size_t PolyphaseResampler::latency_frames() const {
+    return size_t(std::lround((double(up) * taps - 1.0) / (2.0 * down)));
+}
+
+
+uint32_t PolyphaseResampler::upsample_factor() const {
+    return up;
+}
+
+
+uint32_t PolyphaseResampler::downsample_factor() const {
+    return down;
+}
+
+
+const ResamplerConfig& PolyphaseResampler::get_config() const {
+    return config;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "running_stats.hpp"
+#include "simd_kernels.hpp"
+
+
+RunningStats::RunningStats(size_t dimensions) : means(dimensions, 0.0), m2(dimensions, 0.0) {
+    if (dimensions == 0) throw std::invalid_argument("running stats need at least one dimension");
+}
+
+
+/**
+ * Add one vector of dimensions() values.
+ */
+void RunningStats::push(const float* values) {
+    ++samples;
+    simd::welford_update(values, means.size(), 1.0 / double(samples), means.data(), m2.data());
+}
+
+
+/**
+ * Add one value to a single-dimension instance.
+ */
+void RunningStats::push(float value) {
+    push(&value);
+}
+
+
+/**
+ * Combine with statistics gathered elsewhere over the same dimensions.
+ */
+void RunningStats::merge(const RunningStats& other) {
+    if (other.means.size() != means.size()) throw std::invalid_argument("running stats differ in dimensions");
+    if (other.samples == 0) return;
+    if (samples == 0) {
+        *this = other;
+        return;
+    }
+
+    const double total = double(samples) + double(other.samples);
+    const double weight = double(other.samples) / total;
+    const double cross = double(samples) * double(other.samples) / total;
+
+    for (size_t i = 0; i < means.size(); ++i) {
+        double delta = other.means[i] - means[i];
+        means[i] += delta * weight;
+        m2[i] += other.m2[i] + delta * delta * cross;
+    }
+    samples += other.samples;
+}
+
+
+void RunningStats::reset() {
+    std::fill(means.begin(), means.end(), 0.0);
+    std::fill(m2.begin(), m2.end(), 0.0);
+    samples = 0;
+}
+
+
+uint64_t RunningStats::count() const {
+    return samples;
+}
+
+
+size_t RunningStats::dimensions() const {
+    return means.size();
+}
+
+
+std::span<const double> RunningStats::mean() const {
+    return means;
+}
+
+
+/**
+ * Variance of one dimension, divided by count() - ddof (0: numpy's np.var, 1: sample
+ * variance); 0 while fewer than ddof + 1 values are in.
+ */
+double RunningStats::variance(size_t dimension, uint32_t ddof) const {
+    if (samples <= ddof) return 0.0;
+    return m2[dimension] / double(samples - ddof);
+}
+
+
+void RunningStats::variances(float* out, uint32_t ddof) const {
+    for (size_t i = 0; i < means.size(); ++i) out[i] = float(variance(i, ddof));
+}
+
+
+/**
+ * Mean and population variance of every value pushed, all dimensions pooled into
+ * one population (e.g. chroma_stft over its 12 pitch classes).
+ * - every dimension has count() values, so the pooled variance is the mean
+ *   within-dimension variance plus the variance of the dimension means
+ */
+void RunningStats::pooled(float& mean_out, float& variance_out) const {
+    mean_out = variance_out = 0.0f;
+    if (samples == 0) return;
+
+    double mean_sum = 0.0;
+    double m2_sum = 0.0;
+    for (size_t i = 0; i < means.size(); ++i) {
+        mean_sum += means[i];
+        m2_sum += m2[i];
+    }
+    const double mean = mean_sum / means.size();
+
+    double spread = 0.0;
+    for (double m : means) spread += (m - mean) * (m - mean);
+
+    mean_out = float(mean);
+    variance_out = float(m2_sum / (double(samples) * means.size()) + spread / means.size());
+}
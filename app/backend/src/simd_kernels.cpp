@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "simd_kernels.hpp"
+
+
+namespace simd {
+
+namespace detail {
+
+void scalar_downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out) {
+    for (size_t i = 0; i < frames; ++i) {
+        const float* frame = interleaved + i * channels;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c) {
+            sum += weights[c] * frame[c];
+        }
+        out[i] = sum;
+    }
+}
+
+
+/**
+ * Strided copy of frames [first, frames), the tail of the vector versions and the
+ * whole job for odd channel counts and partial channel selections.
+ */
+void scalar_deinterleave(const float* interleaved, size_t first, size_t frames, uint32_t channels, float* const* outs) {
+    for (uint32_t c = 0; c < channels; ++c) {
+        if (!outs[c]) continue;
+        for (size_t i = first; i < frames; ++i) {
+            outs[c][i] = interleaved[i * channels + c];
+        }
+    }
+}
+
+
+float scalar_dot(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+
+float scalar_apply_window(const float* frame, const float* window, float* out, size_t n) {
+    float abs_sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = frame[i] * window[i];
+        abs_sum += std::abs(frame[i]);
+    }
+    return abs_sum;
+}
+
+
+void scalar_power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    for (size_t k = 0; k < bins; ++k) {
+        float re = complex_bins[2 * k];
+        float im = complex_bins[2 * k + 1];
+        out[k] = re * re + im * im;
+    }
+}
+
+
+float scalar_power_to_db(const float* power, size_t n, float eps, float* out) {
+    float max_db = -1e9f;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = 10.0f * std::log10(power[i] + eps);
+        max_db = std::max(max_db, out[i]);
+    }
+    return max_db;
+}
+
+
+SpectralSums scalar_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    SpectralSums sums;
+    for (size_t k = 0; k < bins; ++k) {
+        float m = std::sqrt(power[k]);
+        float weighted = m * freqs[k];
+        float floored = std::max(power[k], amin);
+
+        magnitude[k] = m;
+        sums.magnitude += m;
+        sums.weighted_freq += weighted;
+        sums.power += floored;
+        sums.log_power += std::log(floored);
+    }
+    return sums;
+}
+
+
+void scalar_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    for (size_t i = 0; i < n; ++i) {
+        double delta = x[i] - mean[i];
+        mean[i] += delta * inv_count;
+        m2[i] += delta * (x[i] - mean[i]);
+    }
+}
+
+
+static void scalar_deinterleave_all(const float* interleaved, size_t frames, uint32_t channels, float* const* outs) {
+    scalar_deinterleave(interleaved, 0, frames, channels, outs);
+}
+
+
+const KernelTable* scalar_table() {
+    static const KernelTable table = {
+        Isa::scalar,
+        scalar_downmix,
+        scalar_deinterleave_all,
+        scalar_dot,
+        scalar_apply_window,
+        scalar_power_spectrum,
+        scalar_power_to_db,
+        scalar_spectral_sums,
+        scalar_welford_update,
+    };
+    return &table;
+}
+
+} // namespace detail
+
+
+static const detail::KernelTable* table_for(Isa isa) {
+    switch (isa) {
+        case Isa::scalar: return detail::scalar_table();
+        case Isa::sse2: return detail::sse2_table();
+        case Isa::avx2: return detail::avx2_table();
+        case Isa::avx512: return detail::avx512_table();
+        case Isa::neon: return detail::neon_table();
+    }
+    return nullptr;
+}
+
+
+/**
+ * Whether the table is compiled in and the CPU (and OS) can run it.
+ */
+bool isa_supported(Isa isa) {
+    if (!table_for(isa)) return false;
+
+#if defined(__x86_64__) || defined(__i386__)
+    switch (isa) {
+        case Isa::avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::avx512: return __builtin_cpu_supports("avx512f");
+        default: return true;
+    }
+#else
+    return true;
+#endif
+}
+
+
+static const detail::KernelTable* detect_table() {
+    for (Isa isa : {Isa::avx512, Isa::avx2, Isa::sse2, Isa::neon}) {
+        if (isa_supported(isa)) return table_for(isa);
+    }
+    return detail::scalar_table();
+}
+
+
+static std::atomic<const detail::KernelTable*>& active_table() {
+    static std::atomic<const detail::KernelTable*> table{detect_table()};
+    return table;
+}
+
+
+static const detail::KernelTable& kernels() {
+    return *active_table().load(std::memory_order_relaxed);
+}
+
+
+/**
+ * Force one kernel table, returns false (and keeps the current one) when it cannot
+ * run here.
+ */
+bool set_isa(Isa isa) {
+    if (!isa_supported(isa)) return false;
+
+    active_table().store(table_for(isa), std::memory_order_relaxed);
+    return true;
+}
+
+
+Isa active_isa() {
+    return kernels().isa;
+}
+
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::scalar: return "scalar";
+        case Isa::sse2: return "sse2";
+        case Isa::avx2: return "avx2";
+        case Isa::avx512: return "avx512";
+        case Isa::neon: return "neon";
+    }
+    return "unknown";
+}
+
+
+const char* isa_name() {
+    return isa_name(active_isa());
+}
+
+
+void downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out) {
+    kernels().downmix(interleaved, frames, channels, weights, out);
+}
+
+
+void deinterleave(const float* interleaved, size_t frames, uint32_t channels, float* const* outs) {
+    kernels().deinterleave(interleaved, frames, channels, outs);
+}
+
+
+float dot(const float* a, const float* b, size_t n) {
+    return kernels().dot(a, b, n);
+}
+
+
+float apply_window(const float* frame, const float* window, float* out, size_t n) {
+    return kernels().apply_window(frame, window, out, n);
+}
+
+
+void power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    kernels().power_spectrum(complex_bins, bins, out);
+}
+
+
+float power_to_db(const float* power, size_t n, float eps, float* out) {
+    return kernels().power_to_db(power, n, eps, out);
+}
+
+
+SpectralSums spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    return kernels().spectral_sums(power, freqs, bins, amin, magnitude);
+}
+
+
+void welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    kernels().welford_update(x, n, inv_count, mean, m2);
+}
+
+} // namespace simd
@@ -0,0 +1,251 @@
+#include "simd_kernels.hpp"
+#include "simd_log_constants.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <algorithm>
+#include <arm_neon.h>
+
+
+namespace simd::detail {
+
+static float neon_hsum(float32x4_t v) {
+    float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+}
+
+
+static float neon_hmax(float32x4_t v) {
+    float32x2_t pair = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(pair, pair), 0);
+}
+
+
+static void neon_downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out) {
+    size_t i = 0;
+
+    if (channels == 2) {
+        const float32x4_t w0 = vdupq_n_f32(weights[0]);
+        const float32x4_t w1 = vdupq_n_f32(weights[1]);
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x2_t lr = vld2q_f32(interleaved + 2 * i);
+            vst1q_f32(out + i, vmlaq_f32(vmulq_f32(lr.val[0], w0), lr.val[1], w1));
+        }
+    } else if (channels == 4) {
+        const float32x4_t w0 = vdupq_n_f32(weights[0]);
+        const float32x4_t w1 = vdupq_n_f32(weights[1]);
+        const float32x4_t w2 = vdupq_n_f32(weights[2]);
+        const float32x4_t w3 = vdupq_n_f32(weights[3]);
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x4_t c = vld4q_f32(interleaved + 4 * i);
+            float32x4_t mixed = vmulq_f32(c.val[0], w0);
+            mixed = vmlaq_f32(mixed, c.val[1], w1);
+            mixed = vmlaq_f32(mixed, c.val[2], w2);
+            mixed = vmlaq_f32(mixed, c.val[3], w3);
+            vst1q_f32(out + i, mixed);
+        }
+    }
+
+    scalar_downmix(interleaved + i * channels, frames - i, channels, weights, out + i);
+}
+
+
+static void neon_deinterleave(const float* interleaved, size_t frames, uint32_t channels, float* const* outs) {
+    size_t i = 0;
+
+    if (channels == 2 && outs[0] && outs[1]) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x2_t lr = vld2q_f32(interleaved + 2 * i);
+            vst1q_f32(outs[0] + i, lr.val[0]);
+            vst1q_f32(outs[1] + i, lr.val[1]);
+        }
+    } else if (channels == 4 && outs[0] && outs[1] && outs[2] && outs[3]) {
+        for (; i + 4 <= frames; i += 4) {
+            float32x4x4_t c = vld4q_f32(interleaved + 4 * i);
+            for (int k = 0; k < 4; ++k) vst1q_f32(outs[k] + i, c.val[k]);
+        }
+    }
+
+    scalar_deinterleave(interleaved, i, frames, channels, outs);
+}
+
+
+static float neon_dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return neon_hsum(vaddq_f32(acc0, acc1)) + scalar_dot(a + i, b + i, n - i);
+}
+
+
+static float neon_apply_window(const float* frame, const float* window, float* out, size_t n) {
+    size_t i = 0;
+    float32x4_t abs_sum = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(frame + i);
+        vst1q_f32(out + i, vmulq_f32(x, vld1q_f32(window + i)));
+        abs_sum = vaddq_f32(abs_sum, vabsq_f32(x));
+    }
+    return neon_hsum(abs_sum) + scalar_apply_window(frame + i, window + i, out + i, n - i);
+}
+
+
+static void neon_power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    size_t k = 0;
+    for (; k + 4 <= bins; k += 4) {
+        float32x4x2_t c = vld2q_f32(complex_bins + 2 * k);
+        vst1q_f32(out + k, vmlaq_f32(vmulq_f32(c.val[0], c.val[0]), c.val[1], c.val[1]));
+    }
+    scalar_power_spectrum(complex_bins + 2 * k, bins - k, out + k);
+}
+
+
+static float32x4_t neon_log(float32x4_t x) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    x = vmaxq_f32(x, vdupq_n_f32(MIN_NORMAL));
+
+    int32x4_t exponent = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(x), 23)), vdupq_n_s32(126));
+    float32x4_t e = vcvtq_f32_s32(exponent);
+
+    // mantissa in [0.5, 1)
+    uint32x4_t bits = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(~0x7f800000u));
+    x = vreinterpretq_f32_u32(vorrq_u32(bits, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+
+    uint32x4_t below = vcltq_f32(x, vdupq_n_f32(LOG_SQRTHF));
+    float32x4_t tmp = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(x), below));
+    x = vsubq_f32(x, one);
+    e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(one), below)));
+    x = vaddq_f32(x, tmp);
+
+    float32x4_t z = vmulq_f32(x, x);
+    float32x4_t y = vdupq_n_f32(LOG_P0);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P1), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P2), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P3), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P4), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P5), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P6), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P7), y, x);
+    y = vmlaq_f32(vdupq_n_f32(LOG_P8), y, x);
+    y = vmulq_f32(vmulq_f32(y, x), z);
+
+    y = vmlaq_f32(y, e, vdupq_n_f32(LOG_Q1));
+    y = vmlsq_f32(y, z, vdupq_n_f32(0.5f));
+    x = vaddq_f32(x, y);
+    return vmlaq_f32(x, e, vdupq_n_f32(LOG_Q2));
+}
+
+
+static float neon_power_to_db(const float* power, size_t n, float eps, float* out) {
+    size_t i = 0;
+    const float32x4_t eps4 = vdupq_n_f32(eps);
+    const float32x4_t scale = vdupq_n_f32(DB_PER_NEPER);
+    float32x4_t max_db = vdupq_n_f32(-1e9f);
+
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t db = vmulq_f32(neon_log(vaddq_f32(vld1q_f32(power + i), eps4)), scale);
+        vst1q_f32(out + i, db);
+        max_db = vmaxq_f32(max_db, db);
+    }
+
+    float tail_max = scalar_power_to_db(power + i, n - i, eps, out + i);
+    return std::max(neon_hmax(max_db), tail_max);
+}
+
+
+/**
+ * ARMv7 has no vector sqrt: x * rsqrt(x) with two Newton steps, zero kept at zero.
+ */
+static float32x4_t neon_sqrt(float32x4_t x) {
+#if defined(__aarch64__)
+    return vsqrtq_f32(x);
+#else
+    float32x4_t r = vrsqrteq_f32(x);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));
+    uint32x4_t nonzero = vcgtq_f32(x, vdupq_n_f32(0.0f));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(x, r)), nonzero));
+#endif
+}
+
+
+static SpectralSums neon_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    size_t k = 0;
+    const float32x4_t floor = vdupq_n_f32(amin);
+    float32x4_t mag_sum = vdupq_n_f32(0.0f);
+    float32x4_t freq_sum = vdupq_n_f32(0.0f);
+    float32x4_t power_sum = vdupq_n_f32(0.0f);
+    float32x4_t log_sum = vdupq_n_f32(0.0f);
+
+    for (; k + 4 <= bins; k += 4) {
+        float32x4_t p = vld1q_f32(power + k);
+        float32x4_t f = vld1q_f32(freqs + k);
+        float32x4_t m = neon_sqrt(p);
+        float32x4_t weighted = vmulq_f32(m, f);
+        float32x4_t floored = vmaxq_f32(p, floor);
+
+        vst1q_f32(magnitude + k, m);
+        mag_sum = vaddq_f32(mag_sum, m);
+        freq_sum = vaddq_f32(freq_sum, weighted);
+        power_sum = vaddq_f32(power_sum, floored);
+        log_sum = vaddq_f32(log_sum, neon_log(floored));
+    }
+
+    SpectralSums sums = {neon_hsum(mag_sum), neon_hsum(freq_sum), neon_hsum(power_sum), neon_hsum(log_sum)};
+    sums += scalar_spectral_sums(power + k, freqs + k, bins - k, amin, magnitude + k);
+    return sums;
+}
+
+
+/**
+ * Double state as on x86; ARMv7 NEON has no double lanes and stays scalar.
+ */
+static void neon_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    size_t i = 0;
+#if defined(__aarch64__)
+    const float64x2_t scale = vdupq_n_f64(inv_count);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t v = vcvt_f64_f32(vld1_f32(x + i));
+        float64x2_t m = vld1q_f64(mean + i);
+        float64x2_t delta = vsubq_f64(v, m);
+        m = vfmaq_f64(m, delta, scale);
+        vst1q_f64(mean + i, m);
+        vst1q_f64(m2 + i, vfmaq_f64(vld1q_f64(m2 + i), delta, vsubq_f64(v, m)));
+    }
+#endif
+    scalar_welford_update(x + i, n - i, inv_count, mean + i, m2 + i);
+}
+
+
+const KernelTable* neon_table() {
+    static const KernelTable table = {
+        Isa::neon,
+        neon_downmix,
+        neon_deinterleave,
+        neon_dot,
+        neon_apply_window,
+        neon_power_spectrum,
+        neon_power_to_db,
+        neon_spectral_sums,
+        neon_welford_update,
+    };
+    return &table;
+}
+
+} // namespace simd::detail
+
+#else
+
+namespace simd::detail {
+
+const KernelTable* neon_table() { return nullptr; }
+
+} // namespace simd::detail
+
+#endif
@@ -0,0 +1,665 @@
+#include "simd_kernels.hpp"
+#include "simd_log_constants.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <algorithm>
+#include <immintrin.h>
+
+// AVX2/AVX-512 code is compiled per function, the rest of the build stays baseline x86-64
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+
+namespace simd::detail {
+
+// ---- SSE2 (baseline on x86-64) ---- //
+
+static size_t sse2_downmix_stereo(const float* in, size_t frames, const float* weights, float* out) {
+    size_t i = 0;
+    const __m128 w0 = _mm_set1_ps(weights[0]);
+    const __m128 w1 = _mm_set1_ps(weights[1]);
+
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i);
+        __m128 b = _mm_loadu_ps(in + 2 * i + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(left, w0), _mm_mul_ps(right, w1)));
+    }
+    return i;
+}
+
+
+/**
+ * 4-channel frames, transposed 4 frames at a time.
+ */
+static size_t sse2_downmix_quad(const float* in, size_t frames, const float* weights, float* out) {
+    size_t i = 0;
+    const __m128 w0 = _mm_set1_ps(weights[0]);
+    const __m128 w1 = _mm_set1_ps(weights[1]);
+    const __m128 w2 = _mm_set1_ps(weights[2]);
+    const __m128 w3 = _mm_set1_ps(weights[3]);
+
+    for (; i + 4 <= frames; i += 4) {
+        __m128 c0 = _mm_loadu_ps(in + 4 * i);
+        __m128 c1 = _mm_loadu_ps(in + 4 * i + 4);
+        __m128 c2 = _mm_loadu_ps(in + 4 * i + 8);
+        __m128 c3 = _mm_loadu_ps(in + 4 * i + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        __m128 mixed = _mm_add_ps(_mm_mul_ps(c0, w0), _mm_mul_ps(c1, w1));
+        mixed = _mm_add_ps(mixed, _mm_add_ps(_mm_mul_ps(c2, w2), _mm_mul_ps(c3, w3)));
+        _mm_storeu_ps(out + i, mixed);
+    }
+    return i;
+}
+
+
+static void sse2_downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out) {
+    size_t i = 0;
+    if (channels == 2) i = sse2_downmix_stereo(interleaved, frames, weights, out);
+    else if (channels == 4) i = sse2_downmix_quad(interleaved, frames, weights, out);
+
+    scalar_downmix(interleaved + i * channels, frames - i, channels, weights, out + i);
+}
+
+
+static void sse2_deinterleave(const float* interleaved, size_t frames, uint32_t channels, float* const* outs) {
+    size_t i = 0;
+
+    if (channels == 2 && outs[0] && outs[1]) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+            __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+            _mm_storeu_ps(outs[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(outs[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    } else if (channels == 4 && outs[0] && outs[1] && outs[2] && outs[3]) {
+        for (; i + 4 <= frames; i += 4) {
+            __m128 c0 = _mm_loadu_ps(interleaved + 4 * i);
+            __m128 c1 = _mm_loadu_ps(interleaved + 4 * i + 4);
+            __m128 c2 = _mm_loadu_ps(interleaved + 4 * i + 8);
+            __m128 c3 = _mm_loadu_ps(interleaved + 4 * i + 12);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(outs[0] + i, c0);
+            _mm_storeu_ps(outs[1] + i, c1);
+            _mm_storeu_ps(outs[2] + i, c2);
+            _mm_storeu_ps(outs[3] + i, c3);
+        }
+    }
+
+    scalar_deinterleave(interleaved, i, frames, channels, outs);
+}
+
+
+static float sse2_hsum(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+
+static float sse2_hmax(__m128 v) {
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+
+/**
+ * Four independent accumulators hide the add latency.
+ */
+static float sse2_dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    __m128 acc = _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+    return sse2_hsum(acc) + scalar_dot(a + i, b + i, n - i);
+}
+
+
+static float sse2_apply_window(const float* frame, const float* window, float* out, size_t n) {
+    size_t i = 0;
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 abs_sum = _mm_setzero_ps();
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(frame + i);
+        _mm_storeu_ps(out + i, _mm_mul_ps(x, _mm_loadu_ps(window + i)));
+        abs_sum = _mm_add_ps(abs_sum, _mm_and_ps(x, abs_mask));
+    }
+    return sse2_hsum(abs_sum) + scalar_apply_window(frame + i, window + i, out + i, n - i);
+}
+
+
+static void sse2_power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    size_t k = 0;
+    for (; k + 4 <= bins; k += 4) {
+        __m128 a = _mm_loadu_ps(complex_bins + 2 * k);
+        __m128 b = _mm_loadu_ps(complex_bins + 2 * k + 4);
+        __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + k, _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+    }
+    scalar_power_spectrum(complex_bins + 2 * k, bins - k, out + k);
+}
+
+
+static __m128 sse2_log(__m128 x) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    x = _mm_max_ps(x, _mm_set1_ps(MIN_NORMAL));
+
+    __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(x), 23), _mm_set1_epi32(126));
+    __m128 e = _mm_cvtepi32_ps(exponent);
+
+    // mantissa in [0.5, 1)
+    x = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000)));
+    x = _mm_or_ps(x, _mm_set1_ps(0.5f));
+
+    __m128 below = _mm_cmplt_ps(x, _mm_set1_ps(LOG_SQRTHF));
+    __m128 tmp = _mm_and_ps(x, below);
+    x = _mm_sub_ps(x, one);
+    e = _mm_sub_ps(e, _mm_and_ps(one, below));
+    x = _mm_add_ps(x, tmp);
+
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(LOG_P0);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P1));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P2));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P3));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P4));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P5));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P6));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P7));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(LOG_P8));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(LOG_Q1)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    x = _mm_add_ps(x, y);
+    return _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(LOG_Q2)));
+}
+
+
+static float sse2_power_to_db(const float* power, size_t n, float eps, float* out) {
+    size_t i = 0;
+    const __m128 eps4 = _mm_set1_ps(eps);
+    const __m128 scale = _mm_set1_ps(DB_PER_NEPER);
+    __m128 max_db = _mm_set1_ps(-1e9f);
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 db = _mm_mul_ps(sse2_log(_mm_add_ps(_mm_loadu_ps(power + i), eps4)), scale);
+        _mm_storeu_ps(out + i, db);
+        max_db = _mm_max_ps(max_db, db);
+    }
+
+    float tail_max = scalar_power_to_db(power + i, n - i, eps, out + i);
+    return std::max(sse2_hmax(max_db), tail_max);
+}
+
+
+/**
+ * sqrt, moments and log in one pass, each sum in its own register.
+ */
+static SpectralSums sse2_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    size_t k = 0;
+    const __m128 floor = _mm_set1_ps(amin);
+    __m128 mag_sum = _mm_setzero_ps();
+    __m128 freq_sum = _mm_setzero_ps();
+    __m128 power_sum = _mm_setzero_ps();
+    __m128 log_sum = _mm_setzero_ps();
+
+    for (; k + 4 <= bins; k += 4) {
+        __m128 p = _mm_loadu_ps(power + k);
+        __m128 f = _mm_loadu_ps(freqs + k);
+        __m128 m = _mm_sqrt_ps(p);
+        __m128 weighted = _mm_mul_ps(m, f);
+        __m128 floored = _mm_max_ps(p, floor);
+
+        _mm_storeu_ps(magnitude + k, m);
+        mag_sum = _mm_add_ps(mag_sum, m);
+        freq_sum = _mm_add_ps(freq_sum, weighted);
+        power_sum = _mm_add_ps(power_sum, floored);
+        log_sum = _mm_add_ps(log_sum, sse2_log(floored));
+    }
+
+    SpectralSums sums = {sse2_hsum(mag_sum), sse2_hsum(freq_sum), sse2_hsum(power_sum), sse2_hsum(log_sum)};
+    sums += scalar_spectral_sums(power + k, freqs + k, bins - k, amin, magnitude + k);
+    return sums;
+}
+
+
+/**
+ * The running state is double (a float mean stops moving once the per-frame step
+ * drops below its ulp); two dimensions per step, the floats widened on load.
+ */
+static void sse2_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    size_t i = 0;
+    const __m128d scale = _mm_set1_pd(inv_count);
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(x + i))));
+        __m128d m = _mm_loadu_pd(mean + i);
+        __m128d delta = _mm_sub_pd(v, m);
+        m = _mm_add_pd(m, _mm_mul_pd(delta, scale));
+        _mm_storeu_pd(mean + i, m);
+        _mm_storeu_pd(m2 + i, _mm_add_pd(_mm_loadu_pd(m2 + i), _mm_mul_pd(delta, _mm_sub_pd(v, m))));
+    }
+    scalar_welford_update(x + i, n - i, inv_count, mean + i, m2 + i);
+}
+
+
+const KernelTable* sse2_table() {
+    static const KernelTable table = {
+        Isa::sse2,
+        sse2_downmix,
+        sse2_deinterleave,
+        sse2_dot,
+        sse2_apply_window,
+        sse2_power_spectrum,
+        sse2_power_to_db,
+        sse2_spectral_sums,
+        sse2_welford_update,
+    };
+    return &table;
+}
+
+
+// ---- AVX2 + FMA ---- //
+
+SIMD_TARGET_AVX2 static float avx2_hsum(__m256 v) {
+    __m128 folded = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    return sse2_hsum(folded);
+}
+
+
+SIMD_TARGET_AVX2 static float avx2_hmax(__m256 v) {
+    __m128 folded = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    return sse2_hmax(folded);
+}
+
+
+/**
+ * Stereo gets 8 frames per step, other layouts (and the tail) go through SSE2.
+ */
+SIMD_TARGET_AVX2 static void avx2_downmix(const float* interleaved, size_t frames, uint32_t channels, const float* weights, float* out) {
+    size_t i = 0;
+
+    if (channels == 2) {
+        const __m256 w0 = _mm256_set1_ps(weights[0]);
+        const __m256 w1 = _mm256_set1_ps(weights[1]);
+        for (; i + 8 <= frames; i += 8) {
+            __m256 a = _mm256_loadu_ps(interleaved + 2 * i);         // l0 r0 l1 r1 | l2 r2 l3 r3
+            __m256 b = _mm256_loadu_ps(interleaved + 2 * i + 8);     // l4 r4 l5 r5 | l6 r6 l7 r7
+            __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256 mixed = _mm256_fmadd_ps(right, w1, _mm256_mul_ps(left, w0));
+
+            // shuffles work per 128-bit lane, put the 64-bit pairs back in frame order
+            mixed = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(mixed), _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(out + i, mixed);
+        }
+    }
+
+    sse2_downmix(interleaved + i * channels, frames - i, channels, weights, out + i);
+}
+
+
+SIMD_TARGET_AVX2 static float avx2_dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    return avx2_hsum(_mm256_add_ps(acc0, acc1)) + scalar_dot(a + i, b + i, n - i);
+}
+
+
+SIMD_TARGET_AVX2 static float avx2_apply_window(const float* frame, const float* window, float* out, size_t n) {
+    size_t i = 0;
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 abs_sum = _mm256_setzero_ps();
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(frame + i);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(x, _mm256_loadu_ps(window + i)));
+        abs_sum = _mm256_add_ps(abs_sum, _mm256_and_ps(x, abs_mask));
+    }
+    return avx2_hsum(abs_sum) + scalar_apply_window(frame + i, window + i, out + i, n - i);
+}
+
+
+SIMD_TARGET_AVX2 static void avx2_power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    size_t k = 0;
+    for (; k + 8 <= bins; k += 8) {
+        __m256 a = _mm256_loadu_ps(complex_bins + 2 * k);
+        __m256 b = _mm256_loadu_ps(complex_bins + 2 * k + 8);
+        __m256 re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 power = _mm256_fmadd_ps(im, im, _mm256_mul_ps(re, re));
+
+        power = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(power), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(out + k, power);
+    }
+    sse2_power_spectrum(complex_bins + 2 * k, bins - k, out + k);
+}
+
+
+SIMD_TARGET_AVX2 static __m256 avx2_log(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    x = _mm256_max_ps(x, _mm256_set1_ps(MIN_NORMAL));
+
+    __m256i exponent = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(x), 23), _mm256_set1_epi32(126));
+    __m256 e = _mm256_cvtepi32_ps(exponent);
+
+    x = _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000)));
+    x = _mm256_or_ps(x, _mm256_set1_ps(0.5f));
+
+    __m256 below = _mm256_cmp_ps(x, _mm256_set1_ps(LOG_SQRTHF), _CMP_LT_OQ);
+    __m256 tmp = _mm256_and_ps(x, below);
+    x = _mm256_sub_ps(x, one);
+    e = _mm256_sub_ps(e, _mm256_and_ps(one, below));
+    x = _mm256_add_ps(x, tmp);
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(LOG_P0);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P1));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P2));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P3));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P4));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P5));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P6));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P7));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(LOG_P8));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(LOG_Q1), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    x = _mm256_add_ps(x, y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(LOG_Q2), x);
+}
+
+
+SIMD_TARGET_AVX2 static float avx2_power_to_db(const float* power, size_t n, float eps, float* out) {
+    size_t i = 0;
+    const __m256 eps8 = _mm256_set1_ps(eps);
+    const __m256 scale = _mm256_set1_ps(DB_PER_NEPER);
+    __m256 max_db = _mm256_set1_ps(-1e9f);
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 db = _mm256_mul_ps(avx2_log(_mm256_add_ps(_mm256_loadu_ps(power + i), eps8)), scale);
+        _mm256_storeu_ps(out + i, db);
+        max_db = _mm256_max_ps(max_db, db);
+    }
+
+    float tail_max = sse2_power_to_db(power + i, n - i, eps, out + i);
+    return std::max(avx2_hmax(max_db), tail_max);
+}
+
+
+SIMD_TARGET_AVX2 static SpectralSums avx2_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    size_t k = 0;
+    const __m256 floor = _mm256_set1_ps(amin);
+    __m256 mag_sum = _mm256_setzero_ps();
+    __m256 freq_sum = _mm256_setzero_ps();
+    __m256 power_sum = _mm256_setzero_ps();
+    __m256 log_sum = _mm256_setzero_ps();
+
+    for (; k + 8 <= bins; k += 8) {
+        __m256 p = _mm256_loadu_ps(power + k);
+        __m256 f = _mm256_loadu_ps(freqs + k);
+        __m256 m = _mm256_sqrt_ps(p);
+        __m256 weighted = _mm256_mul_ps(m, f);
+        __m256 floored = _mm256_max_ps(p, floor);
+
+        _mm256_storeu_ps(magnitude + k, m);
+        mag_sum = _mm256_add_ps(mag_sum, m);
+        freq_sum = _mm256_add_ps(freq_sum, weighted);
+        power_sum = _mm256_add_ps(power_sum, floored);
+        log_sum = _mm256_add_ps(log_sum, avx2_log(floored));
+    }
+
+    SpectralSums sums = {avx2_hsum(mag_sum), avx2_hsum(freq_sum), avx2_hsum(power_sum), avx2_hsum(log_sum)};
+    sums += sse2_spectral_sums(power + k, freqs + k, bins - k, amin, magnitude + k);
+    return sums;
+}
+
+
+SIMD_TARGET_AVX2 static void avx2_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    size_t i = 0;
+    const __m256d scale = _mm256_set1_pd(inv_count);
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(x + i));
+        __m256d m = _mm256_loadu_pd(mean + i);
+        __m256d delta = _mm256_sub_pd(v, m);
+        m = _mm256_fmadd_pd(delta, scale, m);
+        _mm256_storeu_pd(mean + i, m);
+        _mm256_storeu_pd(m2 + i, _mm256_fmadd_pd(delta, _mm256_sub_pd(v, m), _mm256_loadu_pd(m2 + i)));
+    }
+    sse2_welford_update(x + i, n - i, inv_count, mean + i, m2 + i);
+}
+
+
+const KernelTable* avx2_table() {
+    static const KernelTable table = {
+        Isa::avx2,
+        avx2_downmix,
+        sse2_deinterleave,      // a pure shuffle, memory bound already at SSE2 width
+        avx2_dot,
+        avx2_apply_window,
+        avx2_power_spectrum,
+        avx2_power_to_db,
+        avx2_spectral_sums,
+        avx2_welford_update,
+    };
+    return &table;
+}
+
+
+// ---- AVX-512F ---- //
+
+// GCC 12 warns about the undefined pass-through operand of the unmasked max/getexp/getmant
+// and _mm512_reduce_* intrinsics, so this section uses the masked forms with an all-ones mask
+static constexpr __mmask16 ALL_LANES = 0xffff;
+
+
+SIMD_TARGET_AVX512 static float avx512_hsum(__m512 v) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, v);
+    return avx2_hsum(_mm256_add_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8)));
+}
+
+
+SIMD_TARGET_AVX512 static float avx512_hmax(__m512 v) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, v);
+    return avx2_hmax(_mm256_max_ps(_mm256_load_ps(lanes), _mm256_load_ps(lanes + 8)));
+}
+
+
+SIMD_TARGET_AVX512 static float avx512_dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    return avx512_hsum(_mm512_add_ps(acc0, acc1)) + avx2_dot(a + i, b + i, n - i);
+}
+
+
+SIMD_TARGET_AVX512 static float avx512_apply_window(const float* frame, const float* window, float* out, size_t n) {
+    size_t i = 0;
+    __m512 abs_sum = _mm512_setzero_ps();
+
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_loadu_ps(frame + i);
+        _mm512_storeu_ps(out + i, _mm512_mul_ps(x, _mm512_loadu_ps(window + i)));
+        abs_sum = _mm512_add_ps(abs_sum, _mm512_abs_ps(x));
+    }
+    return avx512_hsum(abs_sum) + avx2_apply_window(frame + i, window + i, out + i, n - i);
+}
+
+
+SIMD_TARGET_AVX512 static void avx512_power_spectrum(const float* complex_bins, size_t bins, float* out) {
+    size_t k = 0;
+    const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+
+    for (; k + 16 <= bins; k += 16) {
+        __m512 a = _mm512_loadu_ps(complex_bins + 2 * k);
+        __m512 b = _mm512_loadu_ps(complex_bins + 2 * k + 16);
+        __m512 re = _mm512_permutex2var_ps(a, even, b);
+        __m512 im = _mm512_permutex2var_ps(a, odd, b);
+        _mm512_storeu_ps(out + k, _mm512_fmadd_ps(im, im, _mm512_mul_ps(re, re)));
+    }
+    avx2_power_spectrum(complex_bins + 2 * k, bins - k, out + k);
+}
+
+
+/**
+ * Same polynomial as the narrower versions, with getexp/getmant doing the bit work.
+ */
+SIMD_TARGET_AVX512 static __m512 avx512_log(__m512 x) {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    x = _mm512_mask_max_ps(x, ALL_LANES, x, _mm512_set1_ps(MIN_NORMAL));
+
+    __m512 e = _mm512_add_ps(_mm512_mask_getexp_ps(x, ALL_LANES, x), one);
+    x = _mm512_mask_getmant_ps(x, ALL_LANES, x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_src);
+
+    __mmask16 below = _mm512_cmp_ps_mask(x, _mm512_set1_ps(LOG_SQRTHF), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, below, e, one);
+    __m512 x_minus_one = _mm512_sub_ps(x, one);
+    x = _mm512_mask_add_ps(x_minus_one, below, x_minus_one, x);
+
+    __m512 z = _mm512_mul_ps(x, x);
+    __m512 y = _mm512_set1_ps(LOG_P0);
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P1));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P2));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P3));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P4));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P5));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P6));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P7));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(LOG_P8));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, x), z);
+
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(LOG_Q1), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    x = _mm512_add_ps(x, y);
+    return _mm512_fmadd_ps(e, _mm512_set1_ps(LOG_Q2), x);
+}
+
+
+SIMD_TARGET_AVX512 static float avx512_power_to_db(const float* power, size_t n, float eps, float* out) {
+    size_t i = 0;
+    const __m512 eps16 = _mm512_set1_ps(eps);
+    const __m512 scale = _mm512_set1_ps(DB_PER_NEPER);
+    __m512 max_db = _mm512_set1_ps(-1e9f);
+
+    for (; i + 16 <= n; i += 16) {
+        __m512 db = _mm512_mul_ps(avx512_log(_mm512_add_ps(_mm512_loadu_ps(power + i), eps16)), scale);
+        _mm512_storeu_ps(out + i, db);
+        max_db = _mm512_mask_max_ps(max_db, ALL_LANES, max_db, db);
+    }
+
+    float tail_max = avx2_power_to_db(power + i, n - i, eps, out + i);
+    return std::max(avx512_hmax(max_db), tail_max);
+}
+
+
+SIMD_TARGET_AVX512 static SpectralSums avx512_spectral_sums(const float* power, const float* freqs, size_t bins, float amin, float* magnitude) {
+    size_t k = 0;
+    const __m512 floor = _mm512_set1_ps(amin);
+    __m512 mag_sum = _mm512_setzero_ps();
+    __m512 freq_sum = _mm512_setzero_ps();
+    __m512 power_sum = _mm512_setzero_ps();
+    __m512 log_sum = _mm512_setzero_ps();
+
+    for (; k + 16 <= bins; k += 16) {
+        __m512 p = _mm512_loadu_ps(power + k);
+        __m512 f = _mm512_loadu_ps(freqs + k);
+        __m512 m = _mm512_mask_sqrt_ps(p, ALL_LANES, p);
+        __m512 weighted = _mm512_mul_ps(m, f);
+        __m512 floored = _mm512_mask_max_ps(p, ALL_LANES, p, floor);
+
+        _mm512_storeu_ps(magnitude + k, m);
+        mag_sum = _mm512_add_ps(mag_sum, m);
+        freq_sum = _mm512_add_ps(freq_sum, weighted);
+        power_sum = _mm512_add_ps(power_sum, floored);
+        log_sum = _mm512_add_ps(log_sum, avx512_log(floored));
+    }
+
+    SpectralSums sums = {avx512_hsum(mag_sum), avx512_hsum(freq_sum), avx512_hsum(power_sum), avx512_hsum(log_sum)};
+    sums += avx2_spectral_sums(power + k, freqs + k, bins - k, amin, magnitude + k);
+    return sums;
+}
+
+
+SIMD_TARGET_AVX512 static void avx512_welford_update(const float* x, size_t n, double inv_count, double* mean, double* m2) {
+    size_t i = 0;
+    const __m512d scale = _mm512_set1_pd(inv_count);
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_maskz_cvtps_pd(__mmask8(0xFF), _mm256_loadu_ps(x + i));
+        __m512d m = _mm512_loadu_pd(mean + i);
+        __m512d delta = _mm512_sub_pd(v, m);
+        m = _mm512_fmadd_pd(delta, scale, m);
+        _mm512_storeu_pd(mean + i, m);
+        _mm512_storeu_pd(m2 + i, _mm512_fmadd_pd(delta, _mm512_sub_pd(v, m), _mm512_loadu_pd(m2 + i)));
+    }
+    avx2_welford_update(x + i, n - i, inv_count, mean + i, m2 + i);
+}
+
+
+const KernelTable* avx512_table() {
+    static const KernelTable table = {
+        Isa::avx512,
+        avx2_downmix,           // channel shuffles gain nothing from wider registers
+        sse2_deinterleave,
+        avx512_dot,
+        avx512_apply_window,
+        avx512_power_spectrum,
+        avx512_power_to_db,
+        avx512_spectral_sums,
+        avx512_welford_update,
+    };
+    return &table;
+}
+
+} // namespace simd::detail
+
+#else
+
+namespace simd::detail {
+
+const KernelTable* sse2_table() { return nullptr; }
+const KernelTable* avx2_table() { return nullptr; }
+const KernelTable* avx512_table() { return nullptr; }
+
+} // namespace simd::detail
+
+#endif
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cmath>
+
+#include "simd_kernels.hpp"
+#include "spectral_descriptors.hpp"
+
+
+/**
+ * All four descriptors of one power spectrum of `bins` values, `freqs[k]` the
+ * centre frequency of bin k.
+ * - one simd::spectral_sums sweep gives the magnitudes and the sums for centroid
+ *   and flatness; a second walk over the magnitudes, while they are still in L1,
+ *   accumulates the rolloff and the bandwidth
+ * - bandwidth is sum_k m[k] * (f[k] - centroid)^2 centred as in librosa and summed
+ *   in double: E[f^2] - centroid^2 in float cancels to several Hz of error for a
+ *   narrowband tone near 10 kHz
+ * - `magnitude_scratch` takes `bins` values, nothing is allocated
+ * - an all-zero spectrum gives zero centroid, bandwidth and rolloff and a
+ *   flatness of 1, as librosa does for digital silence
+ */
+SpectralDescriptors compute_spectral_descriptors(const float* power, const float* freqs, size_t bins, float* magnitude_scratch) {
+    SpectralDescriptors out;
+    if (bins == 0) return out;
+
+    simd::SpectralSums sums = simd::spectral_sums(power, freqs, bins, SPECTRAL_FLATNESS_AMIN, magnitude_scratch);
+
+    const float inv_bins = 1.0f / float(bins);
+    out.flatness = std::exp(sums.log_power * inv_bins) / (sums.power * inv_bins);
+    if (sums.magnitude <= 0.0f) return out;
+
+    const double centroid = double(sums.weighted_freq) / sums.magnitude;
+    out.centroid = float(centroid);
+
+    const float threshold = SPECTRAL_ROLLOFF_PERCENT * sums.magnitude;
+    float cumulative = 0.0f;
+    size_t rolloff_bin = bins;
+    double spread = 0.0;
+    for (size_t k = 0; k < bins; ++k) {
+        double offset = freqs[k] - centroid;
+        spread += magnitude_scratch[k] * offset * offset;
+
+        cumulative += magnitude_scratch[k];
+        if (rolloff_bin == bins && cumulative >= threshold) rolloff_bin = k;
+    }
+    out.bandwidth = float(std::sqrt(spread / sums.magnitude));
+    out.rolloff = freqs[std::min(rolloff_bin, bins - 1)];
+    return out;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "spsc_ring.hpp"
+
+
+/**
+ * Allocate the ring storage.
+ * - capacity is rounded up to the next power of two (and at least `max_view`)
+ * - storage holds `max_view` extra samples for the mirrored region
+ * - not thread-safe, call before the producer or consumer start
+ */
+bool SpscRing::init(size_t min_capacity, size_t max_view) {
+    size_t capacity = 1;
+    while (capacity < std::max(min_capacity, max_view)) {
+        capacity <<= 1;
+    }
+
+    try {
+        storage.assign(capacity + max_view, 0.0f);
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+
+    ring_capacity = capacity;
+    mask = capacity - 1;
+    view_limit = max_view;
+    reset();
+
+    return true;
+}
+
+
+/**
+ * Drop all buffered samples.
+ * - not thread-safe, only call while neither side is running
+ */
+void SpscRing::reset() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cached_head = 0;
+    cached_tail = 0;
+}
+
+
+/**
+ * Copy samples into the storage starting at an absolute stream position.
+ * - handles the wrap at the end of the ring
+ * - keeps the mirrored region in sync with the first `view_limit` samples
+ */
+void SpscRing::copy_in(uint64_t position, const float* src, size_t count) {
+    size_t offset = position & mask;
+    size_t first = std::min(count, ring_capacity - offset);
+
+    memcpy(storage.data() + offset, src, first * sizeof(float));
+    if (first < count) {
+        memcpy(storage.data(), src + first, (count - first) * sizeof(float));
+    }
+
+    // samples landing in [0, view_limit) are duplicated into the mirror past the end
+    if (offset < view_limit) {
+        size_t mirrored = std::min(first, view_limit - offset);
+        memcpy(storage.data() + ring_capacity + offset, src, mirrored * sizeof(float));
+    }
+    if (first < count) {
+        size_t mirrored = std::min(count - first, view_limit);
+        memcpy(storage.data() + ring_capacity, src + first, mirrored * sizeof(float));
+    }
+}
+
+
+/**
+ * Producer: append up to `count` samples.
+ * - returns the number of samples written, less than `count` when the ring is full
+ * - wait-free, safe to call from the real-time audio thread
+ */
+size_t SpscRing::write(const float* src, size_t count) {
+    uint64_t write_pos = head.load(std::memory_order_relaxed);
+
+    // only reload the consumer position when the cached one says we are out of room
+    size_t space = ring_capacity - size_t(write_pos - cached_tail);
+    if (space < count) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        space = ring_capacity - size_t(write_pos - cached_tail);
+    }
+
+    size_t to_write = std::min(count, space);
+    if (to_write == 0) return 0;
+
+    copy_in(write_pos, src, to_write);
+    head.store(write_pos + to_write, std::memory_order_release);
+
+    return to_write;
+}
+
+
+/**
+ * Producer: number of samples that can currently be written.
+ */
+size_t SpscRing::available_write() const {
+    return ring_capacity - size_t(head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+}
+
+
+/**
+ * Consumer: contiguous view of the next `count` unread samples.
+ * - returns an empty span when fewer than `count` samples are buffered
+ *   or when `count` exceeds `max_view()`
+ * - the view stays valid until `consume` releases it back to the producer
+ */
+std::span<const float> SpscRing::read_view(size_t count) const {
+    if (count == 0 || count > view_limit) return {};
+
+    uint64_t read_pos = tail.load(std::memory_order_relaxed);
+    if (size_t(cached_head - read_pos) < count) {
+        cached_head = head.load(std::memory_order_acquire);
+        if (size_t(cached_head - read_pos) < count) return {};
+    }
+
+    return std::span<const float>(storage.data() + (read_pos & mask), count);
+}
+
+
+/**
+ * Consumer: copy out up to `count` samples and release them.
+ * - works for any length, including reads larger than `max_view()`
+ * - returns the number of samples copied
+ */
+size_t SpscRing::read(float* dest, size_t count) {
+    uint64_t read_pos = tail.load(std::memory_order_relaxed);
+    if (size_t(cached_head - read_pos) < count) {
+        cached_head = head.load(std::memory_order_acquire);
+    }
+
+    size_t to_read = std::min(count, size_t(cached_head - read_pos));
+    size_t offset = read_pos & mask;
+    size_t first = std::min(to_read, ring_capacity - offset);
+
+    memcpy(dest, storage.data() + offset, first * sizeof(float));
+    if (first < to_read) {
+        memcpy(dest + first, storage.data(), (to_read - first) * sizeof(float));
+    }
+
+    tail.store(read_pos + to_read, std::memory_order_release);
+    return to_read;
+}
+
+
+/**
+ * Consumer: release `count` samples previously returned by `read_view`.
+ */
+void SpscRing::consume(size_t count) {
+    tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+
+/**
+ * Consumer: number of samples currently buffered.
+ */
+size_t SpscRing::available_read() const {
+    return size_t(head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed));
+}
+
+
+/**
+ * Total number of samples ever written (monotonic stream position).
+ */
+uint64_t SpscRing::write_position() const {
+    return head.load(std::memory_order_acquire);
+}
+
+
+/**
+ * Total number of samples ever consumed (monotonic stream position).
+ */
+uint64_t SpscRing::read_position() const {
+    return tail.load(std::memory_order_acquire);
+}
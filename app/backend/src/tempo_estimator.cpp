@@ -0,0 +1,154 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "tempo_estimator.hpp"
+
+
+static uint32_t next_power_of_two(uint32_t n) {
+    uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+
+TempoEstimator::TempoEstimator(const TempoConfig& c) : config(c) {
+    if (config.sample_rate == 0 || config.hop_length == 0) throw std::invalid_argument("tempo needs a sample rate and hop length");
+
+    // librosa.time_to_frames floors
+    window_length = uint32_t(config.ac_seconds * config.sample_rate / config.hop_length);
+    if (window_length < 2) throw std::invalid_argument("tempo autocorrelation window is shorter than two frames");
+    half = window_length / 2;
+
+    ac_window.resize(window_length);
+    for (uint32_t i = 0; i < window_length; ++i) {
+        ac_window[i] = float(0.5 - 0.5 * std::cos(2.0 * M_PI * i / window_length));
+    }
+
+    // linear autocorrelation up to lag window_length - 1 needs no wrap-around
+    fft = make_fft_backend(FftBackendKind::kiss, next_power_of_two(2 * window_length));
+    spectrum.resize(fft->size() / 2 + 1);
+
+    envelope.resize(window_length);
+    tempogram_sum.resize(window_length);
+    reset();
+}
+
+
+void TempoEstimator::reset() {
+    padded_length = 0;
+    onsets_pushed = 0;
+    columns = 0;
+    last_onset = 0.0f;
+    std::fill(tempogram_sum.begin(), tempogram_sum.end(), 0.0);
+
+    // left ramp from 0 up to the first onset, which librosa's envelope starts at 0
+    for (uint32_t i = 0; i < half; ++i) append(0.0f);
+}
+
+
+void TempoEstimator::append(float value) {
+    envelope[padded_length % window_length] = value;
+    ++padded_length;
+}
+
+
+/**
+ * Next onset-strength value.
+ */
+void TempoEstimator::push(float onset) {
+    append(onset);
+    ++onsets_pushed;
+    last_onset = onset;
+
+    if (padded_length >= window_length) add_column();
+}
+
+
+/**
+ * Autocorrelation of the window ending at the newest padded value, added to the sum.
+ */
+void TempoEstimator::add_column() {
+    const uint32_t n = fft->size();
+    float* input = fft->input();
+    const uint64_t first = padded_length - window_length;
+
+    for (uint32_t i = 0; i < window_length; ++i) {
+        input[i] = envelope[(first + i) % window_length] * ac_window[i];
+    }
+    std::fill(input + window_length, input + n, 0.0f);
+    fft->execute();
+
+    const float* bins = fft->output();
+    for (size_t k = 0; k < spectrum.size(); ++k) {
+        spectrum[k] = bins[2 * k] * bins[2 * k] + bins[2 * k + 1] * bins[2 * k + 1];
+    }
+
+    // |X|^2 is real and even, so its forward transform is the (scaled) autocorrelation
+    for (uint32_t k = 0; k < n; ++k) {
+        input[k] = spectrum[k <= n / 2 ? k : n - k];
+    }
+    fft->execute();
+
+    const float lag0 = bins[0];
+    if (lag0 > 1e-30f) {
+        for (uint32_t lag = 0; lag < window_length; ++lag) {
+            tempogram_sum[lag] += bins[2 * lag] / lag0;
+        }
+    }
+    ++columns;
+}
+
+
+/**
+ * Tempo in BPM of everything pushed so far; 0 without any onsets.
+ * - closes the envelope with the right-hand ramp, push() must not follow
+ *   without a reset()
+ */
+float TempoEstimator::finish() {
+    if (onsets_pushed == 0) return 0.0f;
+
+    // right ramp from the last onset down to 0, one column per envelope frame
+    for (uint32_t i = 1; columns < onsets_pushed; ++i) {
+        append(i <= half ? last_onset * float(half - i) / float(half) : 0.0f);
+        if (padded_length >= window_length) add_column();
+    }
+    return estimate();
+}
+
+
+/**
+ * Tempo in BPM from the tempogram columns complete so far (the last window_frames() / 2
+ * onsets only count once finish() has run); 0 before the first column.
+ */
+float TempoEstimator::estimate() const {
+    if (columns == 0) return 0.0f;
+
+    const double frames_per_minute = 60.0 * config.sample_rate / config.hop_length;
+    const double log_start = std::log2(double(config.start_bpm));
+
+    float best_bpm = 0.0f;
+    double best_score = -INFINITY;
+    for (uint32_t lag = 1; lag < window_length; ++lag) {
+        double bpm = frames_per_minute / lag;
+        if (bpm >= config.max_bpm) continue;
+
+        double mean = tempogram_sum[lag] / double(columns);
+        double prior = (std::log2(bpm) - log_start) / config.std_bpm;
+        double score = std::log1p(1e6 * mean) - 0.5 * prior * prior;
+        if (score > best_score) {
+            best_score = score;
+            best_bpm = float(bpm);
+        }
+    }
+    return best_bpm;
+}
+
+
+uint32_t TempoEstimator::window_frames() const {
+    return window_length;
+}
+
+
+const TempoConfig& TempoEstimator::get_config() const {
+    return config;
+}
@@ -0,0 +1,84 @@
+#include "thread_pool.hpp"
+
+
+/**
+ * Start the workers.
+ * - a thread count of 0 uses one thread per hardware core
+ */
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) thread_count = default_thread_count();
+
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+
+/**
+ * Finish the queued jobs, then join every worker.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shutting_down = true;
+    }
+    job_available.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+
+size_t ThreadPool::default_thread_count() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+
+/**
+ * Queue a job, it runs on the next free worker.
+ */
+void ThreadPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    job_available.notify_one();
+}
+
+
+/**
+ * Block until the queue is empty and no job is running.
+ */
+void ThreadPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && active_jobs == 0; });
+}
+
+
+void ThreadPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        job_available.wait(lock, [this] { return shutting_down || !jobs.empty(); });
+        if (jobs.empty()) return;
+
+        std::function<void()> job = std::move(jobs.front());
+        jobs.pop_front();
+        ++active_jobs;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        --active_jobs;
+        if (jobs.empty() && active_jobs == 0) idle.notify_all();
+    }
+}
@@ -0,0 +1,78 @@
+#include "wake_event.hpp"
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <algorithm>
+#endif
+
+
+/**
+ * Wake every thread blocked in wait().
+ * - safe to call from the real-time audio thread: without waiters this is one
+ *   atomic load, with waiters it is one bounded futex syscall and never blocks
+ */
+void WakeEvent::notify() {
+    // order the producer's publish (e.g. ring head store) before reading the waiter count,
+    // pairs with the seq_cst increment in wait()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) == 0) return;
+
+    epoch.fetch_add(1, std::memory_order_release);
+
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    sleep_cv.notify_all();
+#endif
+}
+
+
+/**
+ * Make current and future waits return immediately until clear_interrupt().
+ * - used when capture stops so a blocked consumer does not wait forever
+ */
+void WakeEvent::interrupt() {
+    stop_requested.store(true, std::memory_order_seq_cst);
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    notify();
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+
+void WakeEvent::clear_interrupt() {
+    stop_requested.store(false, std::memory_order_seq_cst);
+}
+
+
+bool WakeEvent::interrupted() const {
+    return stop_requested.load(std::memory_order_acquire);
+}
+
+
+/**
+ * Sleep until `epoch` moves away from `seen` or the timeout expires.
+ * - spurious returns are fine, wait() re-checks its predicate
+ */
+void WakeEvent::sleep_while_epoch(uint32_t seen, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+    timespec ts{};
+    timespec* ts_ptr = nullptr;
+    if (timeout != WAIT_FOREVER) {
+        ts.tv_sec = time_t(timeout.count() / 1000000000);
+        ts.tv_nsec = long(timeout.count() % 1000000000);
+        ts_ptr = &ts;
+    }
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, seen, ts_ptr, nullptr, 0);
+#else
+    // notify() cannot take the mutex on the audio thread, so a wake-up can slip in between
+    // the epoch check and the wait; bounding each sleep keeps that race to a few milliseconds
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    std::chrono::nanoseconds slice = std::min<std::chrono::nanoseconds>(timeout, std::chrono::milliseconds(5));
+    sleep_cv.wait_for(lock, slice, [&] { return epoch.load(std::memory_order_acquire) != seen; });
+#endif
+}
@@ -34,6 +34,7 @@ enum class PageId {
 
 struct UIContext {
     std::string selectedDevice;
+    std::string selectedDeviceId;
     std::string selectedTrack;
     std::string trackFilename;
     Track trackData;
@@ -2,13 +2,15 @@
 #include <string>
 #include <vector>
 #include "ui_pages.hpp"
+#include "device_registry.hpp"
 
 PageResult runDeviceSelectPage(WINDOW* win, const UIContext& ctx) {
-    std::vector<std::string> devices = {
-        "Device 1",
-        "Device 2",
-        "Device 3"
-    };
+    // devices come from the shared registry cache, which re-enumerates in the background
+    DeviceRegistry& registry = DeviceRegistry::instance();
+    registry.start_hotplug_monitor();
+
+    uint64_t generation = registry.generation();
+    std::vector<CaptureDeviceInfo> devices = registry.get_capture_devices();
 
     int highlighted = 0;
     int input = 0;
@@ -17,7 +19,16 @@ PageResult runDeviceSelectPage(WINDOW* win, const UIContext& ctx) {
     int xWin;
     getmaxyx(win, yWin, xWin);
 
+    // wake up periodically so hotplugged devices show up while the page is open
+    wtimeout(win, 500);
+
     while (true) {
+        if (registry.generation() != generation) {
+            generation = registry.generation();
+            devices = registry.get_capture_devices();
+            if (highlighted >= (int)devices.size()) highlighted = 0;
+        }
+
         werase(win);
         box(win, '|', '-');
 
@@ -28,12 +39,16 @@ PageResult runDeviceSelectPage(WINDOW* win, const UIContext& ctx) {
             if ((int)i == highlighted) {
                 wattron(win, A_REVERSE);
             }
-            mvwprintw(win, buttonY + i * yWin / 7, buttonX, "[%s]", devices[i].c_str());
+            mvwprintw(win, buttonY + i * yWin / 7, buttonX, "[%s]", devices[i].name.c_str());
             if ((int)i == highlighted) {
                 wattroff(win, A_REVERSE);
             }
         }
 
+        if (devices.empty()) {
+            mvwprintw(win, buttonY, buttonX, "No capture devices found");
+        }
+
         mvwprintw(win, yWin / 28, 2, "Select Device");
         mvwprintw(win, 21 * yWin / 28, 2, "** ENTER to select, LEFT to go back **");
 
@@ -41,21 +56,29 @@ PageResult runDeviceSelectPage(WINDOW* win, const UIContext& ctx) {
         input = wgetch(win);
 
         switch (input) {
+            case ERR:
+                break;
             case KEY_UP:
+                if (devices.empty()) break;
                 highlighted--;
                 if (highlighted < 0) highlighted = (int)devices.size() - 1;
                 break;
             case KEY_DOWN:
+                if (devices.empty()) break;
                 highlighted++;
                 if (highlighted >= (int)devices.size()) highlighted = 0;
                 break;
             case 10:
             case KEY_ENTER: {
+                if (devices.empty()) break;
                 UIContext nextCtx = ctx;
-                nextCtx.selectedDevice = devices[highlighted];
+                nextCtx.selectedDevice = devices[highlighted].name;
+                nextCtx.selectedDeviceId = devices[highlighted].stable_id;
+                wtimeout(win, -1);
                 return {PageId::MainMenu, nextCtx};
             }
             case KEY_LEFT:
+                wtimeout(win, -1);
                 return {PageId::MainMenu, ctx};
         }
     }
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Golden log-mel frames for the LibrosaMelSpectrogram tests.
+
+librosa_mel_golden.txt is librosa's own output (the same call as
+app/AI/inference.py); it needs librosa installed and records its version:
+
+    python3 make_librosa_golden.py > librosa_mel_golden.txt
+
+The parity case is tagged [librosa] and hidden from the default run until this
+file is committed; `test_feature_extractor [librosa]` fails while it is missing.
+
+reference_mel_golden.txt is a standard-library transcription of the same
+computation, kept as an independent cross-check, not as librosa output:
+periodic Hann, zero centre padding, |rfft|^2, librosa.filters.mel (Slaney
+scale, slaney norm) and power_to_db(ref=np.max, amin=1e-10, top_db=80), all in
+double precision.
+
+    python3 make_librosa_golden.py --reference > reference_mel_golden.txt
+"""
+
+import cmath
+import math
+import struct
+import sys
+
+SR = 22050
+N_FFT = 2048
+HOP_LENGTH = 512
+N_MELS = 128
+NUM_SAMPLES = SR // 2
+
+
+def to_float32(x):
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+def test_signal():
+    """Must match golden_signal() in tests/test_feature_extractor.cpp."""
+    samples = []
+    for n in range(NUM_SAMPLES):
+        t = n / SR
+        chirp_hz = 200.0 + 3000.0 * n / NUM_SAMPLES
+        x = 0.5 * math.sin(2 * math.pi * 440.0 * t) \
+            + 0.25 * math.sin(2 * math.pi * 1234.5 * t) \
+            + 0.1 * math.sin(2 * math.pi * chirp_hz * t)
+        samples.append(to_float32(x))
+    return samples
+
+
+def fft(x):
+    n = len(x)
+    if n == 1:
+        return list(x)
+    even = fft(x[0::2])
+    odd = fft(x[1::2])
+    out = [0j] * n
+    for k in range(n // 2):
+        w = cmath.exp(-2j * math.pi * k / n) * odd[k]
+        out[k] = even[k] + w
+        out[k + n // 2] = even[k] - w
+    return out
+
+
+def hz_to_mel(hz):
+    f_sp = 200.0 / 3
+    min_log_hz = 1000.0
+    logstep = math.log(6.4) / 27.0
+    if hz >= min_log_hz:
+        return min_log_hz / f_sp + math.log(hz / min_log_hz) / logstep
+    return hz / f_sp
+
+
+def mel_to_hz(mel):
+    f_sp = 200.0 / 3
+    min_log_hz = 1000.0
+    min_log_mel = min_log_hz / f_sp
+    logstep = math.log(6.4) / 27.0
+    if mel >= min_log_mel:
+        return min_log_hz * math.exp(logstep * (mel - min_log_mel))
+    return f_sp * mel
+
+
+def mel_filters():
+    bins = N_FFT // 2 + 1
+    fftfreqs = [k * SR / N_FFT for k in range(bins)]
+    lo, hi = hz_to_mel(0.0), hz_to_mel(SR / 2)
+    mel_f = [mel_to_hz(lo + (hi - lo) * i / (N_MELS + 1)) for i in range(N_MELS + 2)]
+
+    weights = []
+    for i in range(N_MELS):
+        enorm = 2.0 / (mel_f[i + 2] - mel_f[i])
+        row = []
+        for f in fftfreqs:
+            lower = (f - mel_f[i]) / (mel_f[i + 1] - mel_f[i])
+            upper = (mel_f[i + 2] - f) / (mel_f[i + 2] - mel_f[i + 1])
+            row.append(max(0.0, min(lower, upper)) * enorm)
+        weights.append(row)
+    return weights
+
+
+def reference_mel_db(signal):
+    pad = N_FFT // 2
+    padded = [0.0] * pad + signal + [0.0] * pad
+    window = [0.5 - 0.5 * math.cos(2 * math.pi * n / N_FFT) for n in range(N_FFT)]
+    weights = mel_filters()
+    frames = 1 + len(signal) // HOP_LENGTH
+
+    mel = []
+    for t in range(frames):
+        chunk = padded[t * HOP_LENGTH:t * HOP_LENGTH + N_FFT]
+        spectrum = fft([chunk[n] * window[n] for n in range(N_FFT)])
+        power = [abs(spectrum[k]) ** 2 for k in range(N_FFT // 2 + 1)]
+        mel.append([sum(w * p for w, p in zip(row, power) if w) for row in weights])
+
+    amin, top_db = 1e-10, 80.0
+    ref = max(max(row) for row in mel)
+    db = [[10 * math.log10(max(amin, v)) - 10 * math.log10(max(amin, ref)) for v in row] for row in mel]
+    peak = max(max(row) for row in db)
+    return [[max(v, peak - top_db) for v in row] for row in db], "stdlib transcription, not librosa"
+
+
+def librosa_mel_db(signal):
+    import librosa
+    import numpy as np
+
+    mel = librosa.feature.melspectrogram(y=np.array(signal, dtype=np.float32), sr=SR,
+                                         n_mels=N_MELS, n_fft=N_FFT, hop_length=HOP_LENGTH)
+    db = librosa.power_to_db(mel, ref=np.max)
+    return db.T.tolist(), f"librosa {librosa.__version__}, numpy {np.__version__}"
+
+
+def main():
+    signal = test_signal()
+    if "--reference" in sys.argv[1:]:
+        rows, source = reference_mel_db(signal)
+    else:
+        try:
+            rows, source = librosa_mel_db(signal)
+        except ImportError:
+            sys.exit("librosa is not installed; the librosa golden file must come from librosa itself")
+
+    out = sys.stdout
+    out.write(f"# log-mel frames x mels, generated by make_librosa_golden.py ({source})\n")
+    out.write(f"{len(rows)} {N_MELS}\n")
+    for row in rows:
+        out.write(" ".join(f"{v:.4f}" for v in row) + "\n")
+
+
+if __name__ == "__main__":
+    main()
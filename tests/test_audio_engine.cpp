@@ -1,10 +1,18 @@
 #define CATCH_CONFIG_MAIN
 #include <catch.hpp>
 
-#include <thread>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "audio_engine.hpp"
+#include "capture_manager.hpp"
+#include "device_registry.hpp"
 
 ma_uint32 device_index = 4;
 
@@ -25,8 +33,479 @@ TEST_CASE("AudioEngine Hardware Liveliness", "[audio]") {
     engine.stop();
 
     // check that signal data was moved to the ring buffer
-    ma_pcm_rb* rb = engine.get_ring_buffer();
-    ma_uint32 available = ma_pcm_rb_available_read(rb);
+    SpscRing* rb = engine.get_ring_buffer();
+    size_t available = rb->available_read();
     
     CHECK(available > 0);
-}
\ No newline at end of file
+}
+
+/**
+ * hardware-free: an as-fast-as-possible synthetic source must deliver every frame,
+ * in full chunks, with no gaps
+ */
+TEST_CASE("AudioEngine synthetic source is lossless", "[audio]") {
+    const uint64_t total_frames = SAMPLE_RATE * 3;
+
+    AudioEngine engine(CaptureSourceConfig::synthetic(
+        SyntheticWaveform::sine, 440.0, 0.5, SourcePacing::as_fast_as_possible, total_frames
+    ));
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+    engine.start();
+
+    uint64_t frames_read = 0;
+    uint64_t chunks = 0;
+    bool gaps = false;
+    ChunkInfo info;
+
+    while (true) {
+        std::span<const float> chunk = engine.acquire_chunk_blocking(CHUNK_FRAMES, std::chrono::seconds(5), &info);
+        if (chunk.empty()) break;
+
+        CHECK(info.sequence == chunks);
+        CHECK(info.first_frame == frames_read);
+        gaps = gaps || info.discontinuity;
+
+        frames_read += CHUNK_FRAMES;
+        ++chunks;
+        engine.release_chunk(CHUNK_FRAMES);
+    }
+    engine.stop();
+
+    CHECK(engine.is_source_exhausted());
+    CHECK_FALSE(gaps);
+    CHECK(frames_read == total_frames / CHUNK_FRAMES * CHUNK_FRAMES);
+
+    CaptureStats stats = engine.get_stats();
+    CHECK(stats.frames_captured == total_frames);
+    CHECK(stats.frames_dropped == 0);
+}
+
+
+/**
+ * hardware-free: a WAV file is decoded into the ring unchanged
+ */
+TEST_CASE("AudioEngine file source decodes a WAV file", "[audio]") {
+    const char* path = "test_capture_source.wav";
+    const ma_uint32 total_frames = SAMPLE_RATE / 2;
+
+    std::vector<float> samples(total_frames);
+    for (ma_uint32 i = 0; i < total_frames; ++i) {
+        samples[i] = float(i % 100) / 100.0f - 0.5f;
+    }
+
+    ma_encoder_config encoder_config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, CHANNELS, SAMPLE_RATE);
+    ma_encoder encoder;
+    REQUIRE(ma_encoder_init_file(path, &encoder_config, &encoder) == MA_SUCCESS);
+    ma_encoder_write_pcm_frames(&encoder, samples.data(), total_frames, nullptr);
+    ma_encoder_uninit(&encoder);
+
+    AudioEngine engine(CaptureSourceConfig::file(path, SourcePacing::as_fast_as_possible));
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+    engine.start();
+
+    std::vector<float> chunk(CHUNK_FRAMES);
+    ma_uint32 offset = 0;
+    bool identical = true;
+
+    while (engine.read_chunk_blocking(chunk.data(), CHUNK_FRAMES, std::chrono::seconds(5))) {
+        identical = identical && std::equal(chunk.begin(), chunk.end(), samples.begin() + offset);
+        offset += CHUNK_FRAMES;
+    }
+    engine.stop();
+    std::remove(path);
+
+    CHECK(identical);
+    CHECK(offset == total_frames / CHUNK_FRAMES * CHUNK_FRAMES);
+}
+
+
+/**
+ * hardware-free: stereo input is downmixed with the configured weights into the mono
+ * ring, and a split channel is delivered raw on its own ring
+ */
+TEST_CASE("AudioEngine downmixes and splits multichannel input", "[audio]") {
+    const char* path = "test_capture_stereo.wav";
+    const ma_uint32 total_frames = SAMPLE_RATE / 2;
+
+    std::vector<float> samples(size_t(total_frames) * 2);
+    for (ma_uint32 i = 0; i < total_frames; ++i) {
+        samples[2 * i] = float(i % 100) / 100.0f;
+        samples[2 * i + 1] = -float(i % 37) / 37.0f;
+    }
+
+    ma_encoder_config encoder_config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 2, SAMPLE_RATE);
+    ma_encoder encoder;
+    REQUIRE(ma_encoder_init_file(path, &encoder_config, &encoder) == MA_SUCCESS);
+    ma_encoder_write_pcm_frames(&encoder, samples.data(), total_frames, nullptr);
+    ma_encoder_uninit(&encoder);
+
+    AudioEngineConfig config;
+    config.channels = 2;
+    config.channel_weights = {0.25f, 0.75f};
+    config.split_channels = {1};
+
+    AudioEngine engine(CaptureSourceConfig::file(path, SourcePacing::as_fast_as_possible), config);
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+    engine.start();
+
+    std::vector<float> mono(CHUNK_FRAMES);
+    std::vector<float> right(CHUNK_FRAMES);
+    ma_uint32 offset = 0;
+    bool mixed = true;
+    bool split = true;
+
+    while (engine.read_chunk_blocking(mono.data(), CHUNK_FRAMES, std::chrono::seconds(5))) {
+        REQUIRE(engine.read_channel_chunk(1, right.data(), CHUNK_FRAMES));
+        for (ma_uint32 i = 0; i < CHUNK_FRAMES; ++i) {
+            float left_in = samples[2 * (offset + i)];
+            float right_in = samples[2 * (offset + i) + 1];
+            mixed = mixed && std::abs(mono[i] - (0.25f * left_in + 0.75f * right_in)) < 1e-6f;
+            split = split && right[i] == right_in;
+        }
+        offset += CHUNK_FRAMES;
+    }
+    engine.stop();
+    std::remove(path);
+
+    CHECK(mixed);
+    CHECK(split);
+    CHECK(offset == total_frames / CHUNK_FRAMES * CHUNK_FRAMES);
+    CHECK_FALSE(engine.read_channel_chunk(0, mono.data(), 1));
+
+    AudioEngineConfig bad_weights;
+    bad_weights.channels = 2;
+    bad_weights.channel_weights = {1.0f};
+    AudioEngine rejected(CaptureSourceConfig::synthetic(SyntheticWaveform::silence, 0.0, 0.0), bad_weights);
+    CHECK(rejected.init() == AudioEngine::InitResult::config_failure);
+}
+
+
+/**
+ * hardware-free: real-time pacing delivers audio no faster than a device would
+ */
+TEST_CASE("AudioEngine real-time source is paced", "[audio]") {
+    AudioEngine engine(CaptureSourceConfig::synthetic(SyntheticWaveform::white_noise, 0.0, 0.5));
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+
+    auto started = std::chrono::steady_clock::now();
+    engine.start();
+
+    std::vector<float> chunk(CHUNK_FRAMES);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(engine.read_chunk_blocking(chunk.data(), CHUNK_FRAMES, std::chrono::seconds(2)));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    engine.stop();
+
+    // 10 chunks of 1024 frames are ~213 ms of audio at 48 kHz
+    CHECK(elapsed >= std::chrono::milliseconds(180));
+}
+
+
+/**
+ * hardware-free: runtime capture format and period size are honoured and reported
+ */
+TEST_CASE("AudioEngine runtime configuration", "[audio]") {
+    AudioEngineConfig config;
+    config.sample_rate = 22050;
+    config.ring_frames = 4096;
+    config.period_frames = 256;
+
+    AudioEngine engine(
+        CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 220.0, 0.5, SourcePacing::as_fast_as_possible, 22050),
+        config
+    );
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+
+    const NegotiatedFormat& format = engine.get_negotiated_format();
+    CHECK(format.sample_rate == 22050);
+    CHECK(format.period_frames == 256);
+    CHECK(format.period_ms() == Approx(256.0 * 1000.0 / 22050.0));
+
+    engine.start();
+    std::vector<float> chunk(512);
+    uint64_t frames_read = 0;
+    while (engine.read_chunk_blocking(chunk.data(), 512, std::chrono::seconds(5))) {
+        frames_read += 512;
+    }
+    engine.stop();
+
+    CaptureStats stats = engine.get_stats();
+    CHECK(stats.ring_capacity_frames == 4096);
+    CHECK(stats.frames_captured == 22050);
+    CHECK(stats.ring_high_water_frames <= 4096);
+    CHECK(frames_read == 22050 / 512 * 512);
+}
+
+
+/**
+ * hardware-free: a real-time source with a stalled consumer overruns the ring; every
+ * callback is counted once, in the totals and in the timing histogram
+ */
+TEST_CASE("AudioEngine telemetry counts overruns", "[audio]") {
+    AudioEngineConfig config;
+    config.ring_frames = 4096;
+    config.period_frames = 480;
+    const uint64_t total_frames = 25 * 480;
+
+    AudioEngine engine(
+        CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 440.0, 0.5, SourcePacing::real_time, total_frames),
+        config
+    );
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+
+    // nothing reads the ring until the source has run dry
+    engine.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!engine.is_source_exhausted() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(engine.is_source_exhausted());
+    CaptureStats stats = engine.get_stats();
+    engine.stop();
+
+    const uint64_t capacity = stats.ring_capacity_frames;
+    REQUIRE(capacity == 4096);
+
+    CHECK(stats.callbacks == total_frames / 480);
+    CHECK(stats.frames_captured == capacity);
+    CHECK(stats.frames_dropped == total_frames - capacity);
+    CHECK(stats.frames_captured + stats.frames_dropped == total_frames);
+
+    // the first capacity / period callbacks fit whole, every later one drops frames
+    CHECK(stats.overrun_callbacks == stats.callbacks - capacity / 480);
+    CHECK(stats.ring_fill_frames == capacity);
+    CHECK(stats.ring_high_water_frames == capacity);
+
+    uint64_t histogram_total = 0;
+    for (uint64_t count : stats.callback_time_histogram) {
+        histogram_total += count;
+    }
+    CHECK(histogram_total == stats.callbacks);
+    CHECK(stats.over_budget_callbacks <= stats.callbacks);
+    CHECK(stats.max_callback_ns >= stats.last_callback_ns);
+}
+
+
+/**
+ * hardware-free: frames dropped while the consumer stalls are reported as one gap, on
+ * the chunk that starts where the ring filled up, and reading never returns a partial
+ * chunk
+ */
+TEST_CASE("AudioEngine reports an overrun gap once", "[audio]") {
+    AudioEngineConfig config;
+    config.ring_frames = 4096;
+    config.period_frames = 480;
+    const uint64_t total_frames = 50 * 480;
+
+    AudioEngine engine(
+        CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 440.0, 0.5, SourcePacing::real_time, total_frames),
+        config
+    );
+    REQUIRE(engine.init() == AudioEngine::InitResult::success);
+    engine.start();
+
+    // stall until the ring has overrun, then drain; the ring holds ~85 ms, far longer
+    // than the drain takes, so no second overrun follows
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (engine.get_stats().overrun_callbacks == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(engine.get_stats().overrun_callbacks > 0);
+
+    uint64_t frames_read = 0;
+    uint64_t chunks = 0;
+    std::vector<ChunkInfo> gaps;
+    bool full_chunks = true;
+    ChunkInfo info;
+
+    while (true) {
+        std::span<const float> chunk = engine.acquire_chunk_blocking(CHUNK_FRAMES, std::chrono::seconds(5), &info);
+        if (chunk.empty()) break;
+
+        full_chunks = full_chunks && chunk.size() == CHUNK_FRAMES;
+        CHECK(info.sequence == chunks);
+        CHECK(info.first_frame == frames_read);
+        if (info.discontinuity) gaps.push_back(info);
+
+        frames_read += CHUNK_FRAMES;
+        ++chunks;
+        engine.release_chunk(CHUNK_FRAMES);
+    }
+    CaptureStats stats = engine.get_stats();
+    engine.stop();
+
+    REQUIRE(engine.is_source_exhausted());
+    CHECK(full_chunks);
+    CHECK(frames_read == stats.frames_captured / CHUNK_FRAMES * CHUNK_FRAMES);
+    CHECK(engine.get_ring_buffer()->available_read() == stats.frames_captured - frames_read);
+
+    // the ring filled at stream position 4096, the chunk starting there carries the gap
+    REQUIRE(gaps.size() == 1);
+    CHECK(gaps[0].sequence == 4096 / CHUNK_FRAMES);
+    CHECK(gaps[0].first_frame == 4096);
+    CHECK(gaps[0].gap_sequence == stats.overrun_callbacks);
+    CHECK(gaps[0].frames_lost == stats.frames_dropped);
+    CHECK(stats.frames_captured + stats.frames_dropped == total_frames);
+
+    // chunks after the gap keep reporting its sequence without repeating the loss
+    CHECK(info.gap_sequence == gaps[0].gap_sequence);
+    CHECK_FALSE(info.discontinuity);
+}
+
+
+/**
+ * the registry probes the backend once and serves later calls from its cache
+ */
+TEST_CASE("DeviceRegistry caches the context and device list", "[audio]") {
+    DeviceRegistry& registry = DeviceRegistry::instance();
+
+    ma_context* context = registry.get_context();
+    REQUIRE(context != nullptr);
+    CHECK(registry.get_context() == context);
+
+    std::vector<CaptureDeviceInfo> first = registry.get_capture_devices();
+    uint64_t generation = registry.generation();
+
+    // an unchanged device set must not look like a hotplug event
+    CHECK_FALSE(registry.refresh());
+    CHECK(registry.generation() == generation);
+
+    std::vector<CaptureDeviceInfo> second = registry.get_capture_devices();
+    REQUIRE(second.size() == first.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        CHECK(second[i].stable_id == first[i].stable_id);
+        CHECK(registry.find_device(first[i].stable_id).has_value());
+    }
+}
+
+
+/**
+ * a chunk larger than the ring's view limit could never be acquired, init rejects it
+ * instead of letting the dispatcher spin on it
+ */
+TEST_CASE("CaptureManager rejects chunks larger than the view limit", "[audio]") {
+    CaptureManager manager(AudioEngineConfig{}, 1, MAX_VIEW_FRAMES + 1);
+    manager.add_input(
+        CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 440.0, 0.5, SourcePacing::as_fast_as_possible, SAMPLE_RATE),
+        FeatureExtractorConfig{}
+    );
+    CHECK(manager.init() == AudioEngine::InitResult::config_failure);
+
+    CaptureManager empty_chunks(AudioEngineConfig{}, 1, 0);
+    CHECK(empty_chunks.init() == AudioEngine::InitResult::config_failure);
+}
+
+
+/**
+ * hardware-free: a source that ends mid-chunk still delivers its last frames, as one
+ * final short chunk that also carries the resampler's filter tail
+ */
+TEST_CASE("CaptureManager processes the end of a finite source", "[audio]") {
+    const uint64_t total_frames = 24 * CHUNK_FRAMES + 1000;
+
+    FeatureExtractorConfig capture_rate;
+    FeatureExtractorConfig cnn_rate;
+    cnn_rate.sample_rate = 22050;
+
+    CaptureManager manager(AudioEngineConfig{}, 2);
+    for (const FeatureExtractorConfig& features : {capture_rate, cnn_rate}) {
+        manager.add_input(
+            CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 220.0, 0.5, SourcePacing::as_fast_as_possible, total_frames),
+            features
+        );
+    }
+    REQUIRE(manager.init() == AudioEngine::InitResult::success);
+
+    std::mutex mutex;
+    std::map<size_t, uint64_t> chunks_seen;
+    std::map<size_t, size_t> feature_frames;
+    std::map<size_t, uint64_t> final_chunks;
+    bool final_is_last = true;
+
+    manager.start([&](const InputFeatures& features) {
+        std::lock_guard<std::mutex> lock(mutex);
+        final_is_last = final_is_last && final_chunks[features.input] == 0;
+        CHECK(features.chunk.sequence == chunks_seen[features.input]);
+        chunks_seen[features.input]++;
+        feature_frames[features.input] += features.frame_count;
+        if (features.final_chunk) final_chunks[features.input]++;
+    });
+
+    REQUIRE(manager.wait_until_drained(std::chrono::seconds(10)));
+    manager.stop();
+
+    // frame counts depend only on how many samples reach the extractor
+    std::vector<float> source(total_frames, 0.0f);
+    std::vector<float> resampled;
+    ResamplerConfig resampler_config;
+    resampler_config.input_rate = SAMPLE_RATE;
+    resampler_config.output_rate = cnn_rate.sample_rate;
+    PolyphaseResampler resampler(resampler_config);
+    resampler.process(source.data(), source.size(), resampled);
+    resampler.flush(resampled);
+
+    const size_t expected_frames[] = {
+        FeatureExtractor(capture_rate).max_frames(uint32_t(total_frames)),
+        FeatureExtractor(cnn_rate).max_frames(uint32_t(resampled.size())),
+    };
+
+    CHECK(final_is_last);
+    for (size_t i = 0; i < 2; ++i) {
+        INFO("input " << i);
+        CHECK(chunks_seen[i] == total_frames / CHUNK_FRAMES + 1);
+        CHECK(final_chunks[i] == 1);
+        CHECK(feature_frames[i] == expected_frames[i]);
+        CHECK(manager.engine(i).available_frames() == 0);
+    }
+    // the trailing 1000 frames complete at least one more analysis frame
+    CHECK(expected_frames[0] > FeatureExtractor(capture_rate).max_frames(uint32_t(total_frames / CHUNK_FRAMES * CHUNK_FRAMES)));
+}
+
+
+/**
+ * hardware-free: several inputs share one worker pool, every chunk of every input is
+ * processed exactly once and in order
+ */
+TEST_CASE("CaptureManager processes several inputs on a shared pool", "[audio]") {
+    const uint64_t total_frames = SAMPLE_RATE;
+    const size_t input_count = 3;
+
+    CaptureManager manager(AudioEngineConfig{}, 2);
+    for (size_t i = 0; i < input_count; ++i) {
+        manager.add_input(
+            CaptureSourceConfig::synthetic(SyntheticWaveform::sine, 110.0 * (i + 1), 0.5, SourcePacing::as_fast_as_possible, total_frames),
+            FeatureExtractorConfig{}
+        );
+    }
+    REQUIRE(manager.init() == AudioEngine::InitResult::success);
+
+    std::mutex mutex;
+    std::map<size_t, uint64_t> chunks_seen;
+    std::map<size_t, size_t> feature_frames;
+    bool in_order = true;
+    bool timestamps_ordered = true;
+    std::map<size_t, double> last_timestamp;
+
+    manager.start([&](const InputFeatures& features) {
+        std::lock_guard<std::mutex> lock(mutex);
+        in_order = in_order && features.chunk.sequence == chunks_seen[features.input];
+        if (last_timestamp.count(features.input)) {
+            timestamps_ordered = timestamps_ordered && features.timestamp_sec > last_timestamp[features.input];
+        }
+        last_timestamp[features.input] = features.timestamp_sec;
+        chunks_seen[features.input]++;
+        feature_frames[features.input] += features.frame_count;
+    });
+
+    REQUIRE(manager.wait_until_drained(std::chrono::seconds(10)));
+    manager.stop();
+
+    CHECK(in_order);
+    CHECK(timestamps_ordered);
+    for (size_t i = 0; i < input_count; ++i) {
+        // every full chunk plus the short final one
+        CHECK(chunks_seen[i] == total_frames / CHUNK_FRAMES + 1);
+        CHECK(feature_frames[i] > 0);
+    }
+}
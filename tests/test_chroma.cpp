@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include "chroma.hpp"
+#include "feature_extractor.hpp"
+
+static constexpr uint32_t SAMPLE_RATE = 22050;
+static constexpr uint32_t FFT_SIZE = 2048;
+static constexpr uint32_t A_INDEX = 9;    // C C# D D# E F F# G G# A A# B
+
+
+// one frame of a harmonic tone (fundamental plus two decaying overtones)
+static std::vector<float> power_of_tone(FeatureExtractor& extractor, float hz) {
+    std::vector<float> frame(FFT_SIZE);
+    for (uint32_t i = 0; i < FFT_SIZE; ++i) {
+        float t = float(i) / SAMPLE_RATE;
+        frame[i] = 0.5f * std::sin(2.0f * float(M_PI) * hz * t) + 0.25f * std::sin(4.0f * float(M_PI) * hz * t)
+                   + 0.125f * std::sin(6.0f * float(M_PI) * hz * t);
+    }
+    std::span<const float> power = extractor.compute_power_spectrum(frame.data());
+    return std::vector<float>(power.begin(), power.end());
+}
+
+
+static FeatureExtractor make_extractor() {
+    FeatureExtractorConfig config;
+    config.sample_rate = SAMPLE_RATE;
+    config.fft_size = FFT_SIZE;
+    config.periodic_window = true;
+    return FeatureExtractor(config);
+}
+
+
+static uint32_t strongest(const float* chroma) {
+    return uint32_t(std::max_element(chroma, chroma + NUM_CHROMA) - chroma);
+}
+
+
+TEST_CASE("ChromaExtractor maps a tone to its pitch class", "[chroma]") {
+    FeatureExtractor extractor = make_extractor();
+    ChromaExtractor chroma(ChromaConfig{SAMPLE_RATE, FFT_SIZE});
+
+    ChromaConfig dense_config{SAMPLE_RATE, FFT_SIZE};
+    dense_config.weight_floor = 0.0f;
+    ChromaExtractor dense(dense_config);
+    REQUIRE(dense.weight_count() == size_t(NUM_CHROMA) * (FFT_SIZE / 2 + 1));
+    CHECK(chroma.weight_count() < dense.weight_count() / 2);
+
+    float out[NUM_CHROMA], reference[NUM_CHROMA];
+    for (float hz : {110.0f, 261.63f, 440.0f, 1318.5f}) {
+        std::vector<float> power = power_of_tone(extractor, hz);
+        chroma.compute(power.data(), out);
+        dense.compute(power.data(), reference);
+
+        uint32_t expected = uint32_t(std::lround(12.0 * std::log2(hz / 440.0)) + A_INDEX + 120) % NUM_CHROMA;
+        CHECK(strongest(out) == expected);
+        CHECK(out[expected] == 1.0f);
+        for (uint32_t c = 0; c < NUM_CHROMA; ++c) CHECK(out[c] == Approx(reference[c]).margin(2e-3));
+    }
+
+    std::vector<float> silence(FFT_SIZE / 2 + 1, 0.0f);
+    chroma.compute(silence.data(), out);
+    CHECK(std::all_of(out, out + NUM_CHROMA, [](float v) { return v == 0.0f; }));
+}
+
+
+/**
+ * a band tuned a third of a semitone sharp: the estimate finds the offset and the
+ * retuned filters put its A back on A
+ */
+TEST_CASE("TuningEstimator recovers a detuned reference", "[chroma]") {
+    FeatureExtractor extractor = make_extractor();
+    TuningEstimator estimator(SAMPLE_RATE, FFT_SIZE);
+    CHECK(estimator.estimate() == 0.0f);
+
+    const float offset = 0.33f;
+    const double reference = 440.0 * std::exp2(offset / 12.0);
+    for (int semitone : {-12, -9, -5, -2, 0, 3, 7, 10}) {
+        std::vector<float> power = power_of_tone(extractor, float(reference * std::exp2(semitone / 12.0)));
+        estimator.push(power.data());
+    }
+    CHECK(estimator.peak_count() > 0);
+    // parabolic interpolation of Hann power peaks reads slightly flat, as in piptrack
+    CHECK(estimator.estimate() == Approx(offset).margin(0.05));
+
+    ChromaExtractor chroma(ChromaConfig{SAMPLE_RATE, FFT_SIZE});
+    std::vector<float> power = power_of_tone(extractor, float(reference * std::exp2(0.3 / 12.0)));
+    float out[NUM_CHROMA];
+    chroma.compute(power.data(), out);
+    CHECK(strongest(out) == A_INDEX + 1);
+    chroma.set_tuning(estimator.estimate());
+    chroma.compute(power.data(), out);
+    CHECK(strongest(out) == A_INDEX);
+    CHECK(chroma.get_tuning() == estimator.estimate());
+
+    estimator.reset();
+    CHECK(estimator.peak_count() == 0);
+    CHECK(estimator.estimate() == 0.0f);
+    CHECK_THROWS(TuningEstimator(SAMPLE_RATE, FFT_SIZE, 0.0f));
+}
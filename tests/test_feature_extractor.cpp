@@ -0,0 +1,554 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "feature_extractor.hpp"
+#include "librosa_mel_spectrogram.hpp"
+#include "mel_filterbank.hpp"
+#include "mfcc.hpp"
+#include "offline_feature_extractor.hpp"
+#include "simd_kernels.hpp"
+#include "spectral_descriptors.hpp"
+#include "static_feature_extractor.hpp"
+
+// counting allocator: every heap allocation in this binary goes through here
+// (GCC pairs the inlined malloc/free with new/delete call sites and warns spuriously)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static std::atomic<size_t> allocation_count{0};
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+
+static std::vector<float> make_signal(size_t frames) {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = 0.3f * std::sin(0.05f * i) + 0.1f * std::sin(0.71f * i);
+    }
+    return samples;
+}
+
+
+/**
+ * all three APIs emit the same frames for the same input
+ */
+TEST_CASE("FeatureExtractor span, visitor and vector APIs agree", "[features]") {
+    FeatureExtractorConfig config;
+    const uint32_t chunk = 1000;   // deliberately not a multiple of the hop
+    std::vector<float> signal = make_signal(20 * chunk);
+
+    FeatureExtractor by_vector(config);
+    FeatureExtractor by_span(config);
+    FeatureExtractor by_visitor(config);
+
+    std::vector<float> expected, from_span, from_visitor;
+    std::vector<float> matrix;
+
+    for (size_t offset = 0; offset < signal.size(); offset += chunk) {
+        const float* input = signal.data() + offset;
+
+        for (const std::vector<float>& frame : by_vector.process_samples(input, chunk)) {
+            expected.insert(expected.end(), frame.begin(), frame.end());
+        }
+
+        matrix.resize(by_span.max_frames(chunk) * config.num_mels);
+        size_t frames = by_span.process_samples(input, chunk, std::span<float>(matrix));
+        from_span.insert(from_span.end(), matrix.begin(), matrix.begin() + frames * config.num_mels);
+
+        by_visitor.for_each_frame(input, chunk, [&](std::span<const float> frame) {
+            from_visitor.insert(from_visitor.end(), frame.begin(), frame.end());
+        });
+    }
+
+    REQUIRE_FALSE(expected.empty());
+    CHECK(from_span == expected);
+    CHECK(from_visitor == expected);
+}
+
+
+/**
+ * the circular frame history gives the same frames whatever the chunking
+ */
+TEST_CASE("FeatureExtractor output is independent of chunk size", "[features]") {
+    FeatureExtractorConfig config;
+    std::vector<float> signal = make_signal(50 * config.fft_size + 123);
+
+    FeatureExtractor whole(config);
+    std::vector<std::vector<float>> expected = whole.process_samples(signal.data(), uint32_t(signal.size()));
+    REQUIRE(expected.size() == (signal.size() - config.fft_size) / config.hop_size + 1);
+
+    for (uint32_t chunk : {1u, 7u, 333u, 4096u}) {
+        FeatureExtractor chunked(config);
+        std::vector<std::vector<float>> frames;
+
+        for (size_t offset = 0; offset < signal.size(); offset += chunk) {
+            uint32_t count = uint32_t(std::min<size_t>(chunk, signal.size() - offset));
+            for (std::vector<float>& frame : chunked.process_samples(signal.data() + offset, count)) {
+                frames.push_back(std::move(frame));
+            }
+        }
+        CHECK(frames == expected);
+    }
+}
+
+
+/**
+ * frames that do not fit the caller's matrix are kept for the next call
+ */
+TEST_CASE("FeatureExtractor span API keeps frames that do not fit", "[features]") {
+    FeatureExtractorConfig config;
+    FeatureExtractor extractor(config);
+    std::vector<float> signal = make_signal(4 * config.fft_size);
+
+    std::vector<float> one_frame(config.num_mels);
+    size_t total = extractor.process_samples(signal.data(), uint32_t(signal.size()), std::span<float>(one_frame));
+    CHECK(total == 1);
+    CHECK(extractor.pending_frames() == (signal.size() - config.fft_size) / config.hop_size);
+
+    while (extractor.pending_frames() > 0) {
+        total += extractor.process_samples(nullptr, 0, std::span<float>(one_frame));
+    }
+    CHECK(total == (signal.size() - config.fft_size) / config.hop_size + 1);
+}
+
+
+/**
+ * descriptors of a pure tone and of white noise land where the definitions put them
+ */
+TEST_CASE("FeatureExtractor spectral descriptors", "[features]") {
+    FeatureExtractorConfig config;
+    config.spectral_descriptors = true;
+    const float bin_hz = float(config.sample_rate) / config.fft_size;
+    const float tone_hz = 100.0f * bin_hz;
+
+    std::vector<float> tone(8 * config.fft_size);
+    for (size_t i = 0; i < tone.size(); ++i) tone[i] = 0.5f * std::sin(2.0f * float(M_PI) * tone_hz * i / config.sample_rate);
+
+    FeatureExtractor extractor(config);
+    std::vector<SpectralDescriptors> seen;
+    extractor.for_each_frame(tone.data(), uint32_t(tone.size()), [&](std::span<const float>) {
+        seen.push_back(extractor.frame_descriptors());
+    });
+
+    REQUIRE_FALSE(seen.empty());
+    for (const SpectralDescriptors& d : seen) {
+        CHECK(d.centroid == Approx(tone_hz).margin(bin_hz));
+        CHECK(d.bandwidth < 0.2f * tone_hz);    // window leakage only
+        CHECK(d.rolloff == Approx(tone_hz).margin(bin_hz));
+        CHECK(d.flatness < 1e-3f);
+    }
+
+    // the span overload hands back every row's descriptors, not just the last one's
+    FeatureExtractor rows_extractor(config);
+    std::vector<float> rows(rows_extractor.max_frames(uint32_t(tone.size())) * config.num_mels);
+    std::vector<SpectralDescriptors> row_descriptors(rows.size() / config.num_mels);
+    const uint32_t chunk = 3 * config.hop_size;
+    size_t row = 0;
+    for (size_t offset = 0; offset < tone.size(); offset += chunk) {
+        uint32_t count = uint32_t(std::min<size_t>(chunk, tone.size() - offset));
+        size_t written = rows_extractor.process_samples(tone.data() + offset, count, std::span<float>(rows),
+                                                        std::span<SpectralDescriptors>(row_descriptors));
+        for (size_t i = 0; i < written; ++i, ++row) {
+            REQUIRE(row < seen.size());
+            CHECK(row_descriptors[i].centroid == seen[row].centroid);
+            CHECK(row_descriptors[i].rolloff == seen[row].rolloff);
+        }
+    }
+    CHECK(row == seen.size());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> noise(config.fft_size);
+    for (float& v : noise) v = dist(rng);
+
+    std::vector<float> mel(config.num_mels);
+    SpectralDescriptors d;
+    extractor.compute_frame(noise.data(), mel.data(), &d);
+    CHECK(d.centroid == Approx(0.25f * config.sample_rate).epsilon(0.1));
+    CHECK(d.bandwidth == Approx(0.5f * config.sample_rate / std::sqrt(12.0f)).epsilon(0.1));   // flat over [0, sr / 2]
+    CHECK(d.rolloff == Approx(0.85f * 0.5f * config.sample_rate).epsilon(0.1));
+    CHECK(d.flatness > 0.3f);
+
+    std::vector<float> silence(config.fft_size, 0.0f);
+    extractor.compute_frame(silence.data(), mel.data(), &d);
+    CHECK(d.centroid == 0.0f);
+    CHECK(d.flatness == 1.0f);
+}
+
+
+/**
+ * a narrowband peak near 10 kHz: centroid and bandwidth against a double reference;
+ * E[f^2] - centroid^2 in float would be off by a large fraction of the ~10 Hz width
+ */
+TEST_CASE("Spectral bandwidth of a narrowband high tone", "[features]") {
+    const size_t bins = 1025;
+    const double bin_hz = 22050.0 / 2048.0;
+    const double peak_bin = 10000.0 / bin_hz;
+
+    std::vector<float> freqs(bins), power(bins), scratch(bins);
+    for (size_t k = 0; k < bins; ++k) {
+        freqs[k] = float(k * bin_hz);
+        double distance = (double(k) - peak_bin) / 1.5;
+        power[k] = float(std::exp(-distance * distance)) + 1e-12f;
+    }
+
+    double magnitude = 0.0, weighted = 0.0;
+    for (size_t k = 0; k < bins; ++k) {
+        double m = std::sqrt(double(power[k]));
+        magnitude += m;
+        weighted += m * freqs[k];
+    }
+    const double centroid = weighted / magnitude;
+    double spread = 0.0;
+    for (size_t k = 0; k < bins; ++k) {
+        spread += std::sqrt(double(power[k])) * (freqs[k] - centroid) * (freqs[k] - centroid);
+    }
+    const double bandwidth = std::sqrt(spread / magnitude);
+
+    const simd::Isa active = simd::active_isa();
+    for (simd::Isa isa : {simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2, simd::Isa::avx512, simd::Isa::neon}) {
+        if (!simd::set_isa(isa)) continue;
+        INFO(simd::isa_name(isa));
+
+        SpectralDescriptors d = compute_spectral_descriptors(power.data(), freqs.data(), bins, scratch.data());
+        CHECK(d.centroid == Approx(centroid).margin(0.01));
+        CHECK(d.bandwidth == Approx(bandwidth).margin(0.01));
+    }
+    simd::set_isa(active);
+}
+
+
+/**
+ * the compile-time shapes reproduce the dynamic extractor up to FFT rounding
+ */
+template <typename Static>
+static void check_static_matches_dynamic() {
+    FeatureExtractorConfig config;
+    config.fft_size = Static::fft_size;
+    config.hop_size = Static::hop_size;
+    config.num_mels = Static::num_mels;
+    std::vector<float> signal = make_signal(40 * config.fft_size + 77);
+
+    FeatureExtractor dynamic(config);
+    Static fixed(config);
+
+    std::vector<float> expected, actual;
+    dynamic.for_each_frame(signal.data(), uint32_t(signal.size()), [&](std::span<const float> frame) {
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    });
+    fixed.for_each_frame(signal.data(), uint32_t(signal.size()), [&](std::span<const float> frame) {
+        actual.insert(actual.end(), frame.begin(), frame.end());
+    });
+
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(actual[i] == Approx(expected[i]).margin(1e-2));
+    }
+
+    // both gate silence on the raw samples: energy only where the window is zero is not silent
+    std::vector<float> edge(config.fft_size, 0.0f);
+    edge[0] = 2.0f * config.silence_threshold;
+    std::vector<float> dynamic_out(config.num_mels), fixed_out(config.num_mels);
+    dynamic.compute_frame(edge.data(), dynamic_out.data());
+    fixed.compute_frame(edge.data(), fixed_out.data());
+    CHECK(dynamic_out[0] != -config.top_db);
+    for (uint32_t m = 0; m < config.num_mels; ++m) {
+        REQUIRE(fixed_out[m] == Approx(dynamic_out[m]).margin(1e-2));
+    }
+}
+
+TEST_CASE("StaticFeatureExtractor matches FeatureExtractor", "[features]") {
+    check_static_matches_dynamic<LiveFeatureExtractor>();
+    check_static_matches_dynamic<CnnFeatureExtractor>();
+}
+
+
+/**
+ * extractors of one shape share a single set of tables, freed with the last user
+ */
+TEST_CASE("FeatureExtractor shares analysis tables between instances", "[features]") {
+    FeatureExtractorConfig config;
+    config.num_mels = 23;   // a shape no other test keeps alive
+    const size_t before = AnalysisTables::live_count();
+
+    {
+        FeatureExtractor first(config);
+        FeatureExtractor second(config);
+        LiveFeatureExtractor fixed;
+        REQUIRE(AnalysisTables::live_count() == before + 2);
+
+        config.fmax = 8000.0f;
+        FeatureExtractor narrow(config);
+        REQUIRE(AnalysisTables::live_count() == before + 3);
+
+        // shared tables still give each instance its own results
+        std::vector<float> signal = make_signal(8 * config.fft_size);
+        std::vector<float> a(first.max_frames(uint32_t(signal.size())) * 23);
+        std::vector<float> b(a.size());
+        REQUIRE(first.process_samples(signal.data(), uint32_t(signal.size()), a) == second.process_samples(signal.data(), uint32_t(signal.size()), b));
+        REQUIRE(a == b);
+    }
+
+    REQUIRE(AnalysisTables::live_count() == before);
+}
+
+
+// dense num_mels x (fft_size / 2 + 1) HTK filter matrix, written out from the formula
+static std::vector<std::vector<double>> dense_htk_filterbank(uint32_t sample_rate, uint32_t fft_size, uint32_t num_mels, float fmin, float fmax) {
+    const size_t num_bins = fft_size / 2 + 1;
+    auto to_mel = [](float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); };
+    auto to_hz = [](float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); };
+
+    std::vector<int> bins(num_mels + 2);
+    for (uint32_t i = 0; i < bins.size(); ++i) {
+        float mel = to_mel(fmin) + (to_mel(fmax) - to_mel(fmin)) * i / (num_mels + 1);
+        bins[i] = std::min(int(fft_size / 2), int(std::floor((fft_size + 1) * to_hz(mel) / sample_rate)));
+    }
+
+    std::vector<std::vector<double>> matrix(num_mels, std::vector<double>(num_bins, 0.0));
+    for (uint32_t m = 0; m < num_mels; ++m) {
+        double sum = 0.0;
+        for (size_t k = 0; k < num_bins; ++k) {
+            int bin = int(k);
+            if (bin >= bins[m] && bin < bins[m + 1]) matrix[m][k] = double(bin - bins[m]) / (bins[m + 1] - bins[m]);
+            if (bin >= bins[m + 1] && bin < bins[m + 2]) matrix[m][k] = double(bins[m + 2] - bin) / (bins[m + 2] - bins[m + 1]);
+            sum += matrix[m][k];
+        }
+        for (double& w : matrix[m]) w = sum > 0.0 ? w / sum : w;
+    }
+    return matrix;
+}
+
+
+// dense librosa.filters.mel(htk=False, norm="slaney") matrix
+static std::vector<std::vector<double>> dense_slaney_filterbank(uint32_t sample_rate, uint32_t fft_size, uint32_t num_mels, float fmin, float fmax) {
+    const size_t num_bins = fft_size / 2 + 1;
+    const double min_log_mel = 1000.0 / (200.0 / 3.0);
+    const double log_step = std::log(6.4) / 27.0;
+    auto to_mel = [&](double hz) { return hz < 1000.0 ? hz / (200.0 / 3.0) : min_log_mel + std::log(hz / 1000.0) / log_step; };
+    auto to_hz = [&](double mel) { return mel < min_log_mel ? mel * (200.0 / 3.0) : 1000.0 * std::exp(log_step * (mel - min_log_mel)); };
+
+    std::vector<double> edges(num_mels + 2);
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        edges[i] = to_hz(to_mel(fmin) + (to_mel(fmax) - to_mel(fmin)) * i / (num_mels + 1));
+    }
+
+    std::vector<std::vector<double>> matrix(num_mels, std::vector<double>(num_bins, 0.0));
+    for (uint32_t m = 0; m < num_mels; ++m) {
+        for (size_t k = 0; k < num_bins; ++k) {
+            double hz = double(k) * sample_rate / fft_size;
+            double rising = (hz - edges[m]) / (edges[m + 1] - edges[m]);
+            double falling = (edges[m + 2] - hz) / (edges[m + 2] - edges[m + 1]);
+            matrix[m][k] = std::max(0.0, std::min(rising, falling)) * 2.0 / (edges[m + 2] - edges[m]);
+        }
+    }
+    return matrix;
+}
+
+
+/**
+ * the sparse band layout projects exactly like the full filter matrix, at the CNN's
+ * 128 mels over a 2048-point FFT
+ */
+TEST_CASE("MelFilterbank sparse projection matches a dense matrix-vector product", "[features]") {
+    const uint32_t sample_rate = 22050, fft_size = 2048, num_mels = 128;
+    const size_t num_bins = fft_size / 2 + 1;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<float> power(num_bins);
+    for (float& p : power) p = uniform(rng);
+
+    for (MelScale scale : {MelScale::htk, MelScale::slaney}) {
+        INFO((scale == MelScale::htk ? "htk" : "slaney"));
+        MelFilterbank bank = build_mel_filterbank(sample_rate, fft_size, num_mels, 0.0f, sample_rate / 2.0f, scale);
+        std::vector<std::vector<double>> dense = scale == MelScale::htk
+            ? dense_htk_filterbank(sample_rate, fft_size, num_mels, 0.0f, sample_rate / 2.0f)
+            : dense_slaney_filterbank(sample_rate, fft_size, num_mels, 0.0f, sample_rate / 2.0f);
+
+        REQUIRE(bank.bands.size() == num_mels);
+        CHECK(bank.weights.size() < 2 * num_bins);
+
+        std::vector<float> mel_power(num_mels);
+        bank.project(power.data(), mel_power.data());
+
+        double max_error = 0.0;
+        for (uint32_t m = 0; m < num_mels; ++m) {
+            double expected = 0.0;
+            for (size_t k = 0; k < num_bins; ++k) {
+                expected += dense[m][k] * power[k];
+            }
+            max_error = std::max(max_error, std::abs(mel_power[m] - expected) / std::max(expected, 1e-12));
+        }
+        CHECK(max_error < 1e-5);
+    }
+}
+
+
+/**
+ * the parallel offline pass gives exactly the serial frames, in order
+ */
+TEST_CASE("OfflineFeatureExtractor matches serial extraction", "[features]") {
+    FeatureExtractorConfig config;
+    std::vector<float> signal = make_signal(10 * config.sample_rate + 321);
+
+    FeatureExtractor serial(config);
+    std::vector<float> expected;
+    serial.for_each_frame(signal.data(), uint32_t(signal.size()), [&](std::span<const float> frame) {
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    });
+
+    OfflineFeatureExtractor offline(config, 4);
+    REQUIRE(offline.thread_count() == 4);
+
+    FeatureMatrix matrix = offline.process(signal.data(), signal.size());
+    CHECK(matrix.frames == expected.size() / config.num_mels);
+    CHECK(matrix.num_mels == config.num_mels);
+    CHECK(matrix.data == expected);
+
+    FeatureMatrix empty = offline.process(signal.data(), config.fft_size - 1);
+    CHECK(empty.frames == 0);
+}
+
+
+/**
+ * after warm-up, steady-state extraction does not touch the heap
+ */
+TEST_CASE("FeatureExtractor steady state is allocation-free", "[features]") {
+    FeatureExtractorConfig config;
+    config.fft_size = 2048;
+    config.num_mels = 128;
+    config.spectral_descriptors = true;
+
+    const uint32_t chunk = 1024;
+    std::vector<float> signal = make_signal(64 * chunk);
+    FeatureExtractor extractor(config);
+
+    std::vector<float> matrix((chunk / config.hop_size + 1) * config.num_mels);
+    float checksum = 0.0f;
+
+    MfccConfig mfcc_config;
+    mfcc_config.num_mels = config.num_mels;
+    mfcc_config.lifter = 22.0f;
+    mfcc_config.deltas = true;
+    MfccStage mfcc(mfcc_config);
+    std::vector<float> cepstrum(mfcc.frame_size());
+
+    // warm-up: the sample buffer grows to its working size
+    for (size_t offset = 0; offset < 8 * chunk; offset += chunk) {
+        extractor.process_samples(signal.data() + offset, chunk, std::span<float>(matrix));
+    }
+
+    size_t before = allocation_count.load();
+    size_t frames = 0;
+    for (size_t offset = 8 * chunk; offset < signal.size(); offset += 2 * chunk) {
+        frames += extractor.process_samples(signal.data() + offset, chunk, std::span<float>(matrix));
+        frames += extractor.for_each_frame(signal.data() + offset + chunk, chunk, [&](std::span<const float> frame) {
+            if (mfcc.push(frame.data(), cepstrum.data())) checksum += cepstrum[0];
+            checksum += extractor.frame_descriptors().centroid;
+        });
+    }
+    size_t allocations = allocation_count.load() - before;
+
+    CHECK(frames > 0);
+    CHECK(allocations == 0);
+}
+
+
+// the input of data/make_librosa_golden.py, computed the same way
+static std::vector<float> golden_signal() {
+    const double sr = 22050.0;
+    const size_t count = 22050 / 2;
+    std::vector<float> samples(count);
+    for (size_t n = 0; n < count; ++n) {
+        double t = n / sr;
+        double chirp_hz = 200.0 + 3000.0 * n / count;
+        samples[n] = float(0.5 * std::sin(2 * M_PI * 440.0 * t)
+                         + 0.25 * std::sin(2 * M_PI * 1234.5 * t)
+                         + 0.1 * std::sin(2 * M_PI * chirp_hz * t));
+    }
+    return samples;
+}
+
+
+// largest |golden - LibrosaMelSpectrogram| in dB over a golden file's frames
+static double golden_deviation(std::ifstream& golden) {
+    size_t frames = 0, mels = 0;
+    golden >> frames >> mels;
+
+    std::vector<float> signal = golden_signal();
+    LibrosaMelSpectrogram librosa;
+    FeatureMatrix matrix = librosa.compute(signal.data(), signal.size());
+
+    REQUIRE(matrix.frames == frames);
+    REQUIRE(matrix.num_mels == mels);
+
+    double worst = 0.0;
+    for (size_t i = 0; i < frames * mels; ++i) {
+        double expected = 0.0;
+        golden >> expected;
+        worst = std::max(worst, std::abs(expected - matrix.data[i]));
+    }
+    REQUIRE(golden.good());
+    return worst;
+}
+
+
+/**
+ * librosa parity mode reproduces the CNN preprocessing of app/AI/inference.py
+ * - data/librosa_mel_golden.txt is librosa's own output, written by
+ *   data/make_librosa_golden.py on a machine with librosa installed
+ * - hidden until that file is committed: run it explicitly with
+ *   `test_feature_extractor [librosa]`, a missing file fails the case
+ */
+TEST_CASE("LibrosaMelSpectrogram matches librosa", "[.][features][librosa]") {
+    std::ifstream golden("data/librosa_mel_golden.txt");
+    INFO("data/librosa_mel_golden.txt is written by data/make_librosa_golden.py with librosa installed");
+    REQUIRE(golden.good());
+
+    std::string header;
+    std::getline(golden, header);
+    INFO(header);
+    REQUIRE(header.find("(librosa ") != std::string::npos);
+
+    double worst = golden_deviation(golden);
+    INFO("largest deviation " << worst << " dB");
+    CHECK(worst < 0.01);
+}
+
+
+/**
+ * the same computation transcribed independently (make_librosa_golden.py --reference)
+ */
+TEST_CASE("LibrosaMelSpectrogram matches the reference transcription", "[features]") {
+    std::ifstream golden("data/reference_mel_golden.txt");
+    REQUIRE(golden.good());
+
+    std::string header;
+    std::getline(golden, header);
+
+    double worst = golden_deviation(golden);
+    INFO("largest deviation " << worst << " dB");
+    CHECK(worst < 0.01);
+}
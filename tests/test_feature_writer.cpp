@@ -27,10 +27,10 @@ int main() {
     FeatureWriter writer(testFile);
 
     try {
-        writer.openFile();
-        assertTrue(true, "openFile() opens file succesfully");
+        writer.open_file();
+        assertTrue(true, "open_file() opens file succesfully");
     } catch(...) {
-        assertTrue(false, "openFile() opens file succesfully");
+        assertTrue(false, "open_file() opens file succesfully");
     }
 
     //Test 2: Write Row
@@ -38,13 +38,13 @@ int main() {
     std::vector<float> features = {1.0f, 2.5f, 3.75f};
 
     try{
-        writer.writeRow(features);
-        assertTrue(true, "writeRow() writes data without throwing");
+        writer.write_row(features);
+        assertTrue(true, "write_row() writes data without throwing");
     } catch(...) {
-        assertTrue(false, "writeRow() writes data without throwing");
+        assertTrue(false, "write_row() writes data without throwing");
     }
 
-    writer.closeFile();
+    writer.close_file();
 
     // Test 3: Verify file contents
 
@@ -0,0 +1,178 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "batch_fft.hpp"
+#include "feature_extractor.hpp"
+#include "fft_backend.hpp"
+
+
+/**
+ * every backend built into this binary computes the same unnormalised r2c transform
+ */
+TEST_CASE("FFT backends match a reference DFT", "[fft]") {
+    for (FftBackendKind kind : {FftBackendKind::kiss, FftBackendKind::fftw}) {
+        if (!fft_backend_available(kind)) continue;
+
+        for (uint32_t size : {64u, 1024u}) {
+            DYNAMIC_SECTION(fft_backend_name(kind) << " size " << size) {
+                std::unique_ptr<FftBackend> fft = make_fft_backend(kind, size);
+                REQUIRE(fft->kind() == kind);
+                REQUIRE(fft->size() == size);
+
+                std::vector<double> signal(size);
+                for (uint32_t n = 0; n < size; ++n) {
+                    signal[n] = std::sin(0.3 * n) + 0.25 * std::cos(1.7 * n) + (n % 5) * 0.1;
+                    fft->input()[n] = float(signal[n]);
+                }
+                fft->execute();
+
+                const float* bins = fft->output();
+                for (uint32_t k = 0; k <= size / 2; ++k) {
+                    double re = 0.0, im = 0.0;
+                    for (uint32_t n = 0; n < size; ++n) {
+                        double phase = -2.0 * M_PI * double(k) * n / size;
+                        re += signal[n] * std::cos(phase);
+                        im += signal[n] * std::sin(phase);
+                    }
+                    REQUIRE(bins[2 * k] == Approx(re).margin(1e-3 * size));
+                    REQUIRE(bins[2 * k + 1] == Approx(im).margin(1e-3 * size));
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * the runtime selection only ever picks a backend that is built in
+ */
+TEST_CASE("FFT backend benchmark picks an available backend", "[fft]") {
+    std::vector<FftBenchmarkResult> results = benchmark_fft_backends(1024);
+    REQUIRE(results.size() == (fft_backend_available(FftBackendKind::fftw) ? 2u : 1u));
+    for (size_t i = 1; i < results.size(); ++i) {
+        CHECK(results[i - 1].ns_per_transform <= results[i].ns_per_transform);
+    }
+
+    FftBackendKind fastest = fastest_fft_backend(1024);
+    CHECK(fft_backend_available(fastest));
+    CHECK(fastest != FftBackendKind::automatic);
+    CHECK(fastest_fft_backend(1024) == fastest);
+
+    std::unique_ptr<FftBackend> automatic = make_fft_backend(FftBackendKind::automatic, 1024);
+    CHECK(automatic->kind() == fastest);
+}
+
+
+/**
+ * benchmarked selection is opt-in, and wisdom never lands in the working directory
+ */
+TEST_CASE("FFT backend defaults", "[fft]") {
+    CHECK(FeatureExtractorConfig{}.fft_backend == FftBackendKind::kiss);
+
+    std::string wisdom = default_fftw_wisdom_file();
+    CHECK((wisdom.empty() || wisdom.front() == '/'));
+}
+
+
+/**
+ * FFTW builds only: a size the wisdom does not cover is measured once and the
+ * wisdom file is written, creating its directory
+ */
+TEST_CASE("FFTW wisdom is exported for newly planned sizes", "[fft]") {
+    if (!fft_backend_available(FftBackendKind::fftw)) {
+        WARN("built without <fftw3.h>, FFTW wisdom not tested");
+        return;
+    }
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "guitar_genre_guru_wisdom_test";
+    std::filesystem::remove_all(dir);
+    const std::filesystem::path path = dir / "fftw_wisdom.dat";
+    set_fftw_wisdom_file(path.string());
+
+    {
+        std::unique_ptr<FftBackend> fft = make_fft_backend(FftBackendKind::fftw, 96);
+        CHECK(fft->kind() == FftBackendKind::fftw);
+    }
+    REQUIRE(std::filesystem::exists(path));
+
+    std::ifstream wisdom(path);
+    std::string header;
+    std::getline(wisdom, header);
+    CHECK(header.find("fftwf_wisdom") != std::string::npos);
+
+    set_fftw_wisdom_file(default_fftw_wisdom_file());
+    std::filesystem::remove_all(dir);
+}
+
+
+/**
+ * FFTW builds only: the extractor gives the same log-mel frames on either backend
+ */
+TEST_CASE("FeatureExtractor agrees across FFT backends", "[fft]") {
+    if (!fft_backend_available(FftBackendKind::fftw)) {
+        WARN("built without <fftw3.h>, only kissfft is available");
+        return;
+    }
+
+    std::vector<float> signal(8 * 1024);
+    for (size_t i = 0; i < signal.size(); ++i) signal[i] = 0.3f * std::sin(0.05f * i) + 0.1f * std::sin(0.71f * i);
+
+    std::vector<std::vector<float>> frames;
+    for (FftBackendKind kind : {FftBackendKind::kiss, FftBackendKind::fftw}) {
+        FeatureExtractorConfig config;
+        config.fft_backend = kind;
+        FeatureExtractor extractor(config);
+        CHECK(extractor.get_fft_backend() == kind);
+        frames.emplace_back(extractor.max_frames(uint32_t(signal.size())) * config.num_mels);
+        extractor.process_samples(signal.data(), uint32_t(signal.size()), std::span<float>(frames.back()));
+    }
+
+    REQUIRE(frames[0].size() == frames[1].size());
+    for (size_t i = 0; i < frames[0].size(); ++i) {
+        REQUIRE(frames[1][i] == Approx(frames[0][i]).margin(1e-3));
+    }
+}
+
+
+/**
+ * each lane of the 4-wide kissfft equals a scalar kissfft of the same frame
+ */
+TEST_CASE("BatchFft4 lanes match the scalar backend", "[fft]") {
+    const uint32_t size = 1024;
+    const size_t bins = size / 2 + 1;
+
+    std::vector<std::vector<float>> frames(BATCH_FFT_LANES, std::vector<float>(size));
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        for (uint32_t n = 0; n < size; ++n) {
+            frames[lane][n] = std::sin(0.01f * (lane + 1) * n) + 0.1f * float((n * (lane + 3)) % 7);
+        }
+    }
+
+    BatchFft4 batch(size);
+    const float* inputs[BATCH_FFT_LANES];
+    std::vector<std::vector<float>> spectra(BATCH_FFT_LANES, std::vector<float>(2 * bins));
+    float* outputs[BATCH_FFT_LANES];
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        inputs[lane] = frames[lane].data();
+        outputs[lane] = spectra[lane].data();
+    }
+    batch.load(inputs);
+    batch.execute();
+    batch.spectra(outputs);
+
+    std::unique_ptr<FftBackend> scalar = make_fft_backend(FftBackendKind::kiss, size);
+    for (uint32_t lane = 0; lane < BATCH_FFT_LANES; ++lane) {
+        std::copy(frames[lane].begin(), frames[lane].end(), scalar->input());
+        scalar->execute();
+        for (size_t i = 0; i < 2 * bins; ++i) {
+            REQUIRE(spectra[lane][i] == scalar->output()[i]);
+        }
+    }
+}
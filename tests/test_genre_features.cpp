@@ -0,0 +1,145 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "genre_feature_extractor.hpp"
+#include "tempo_estimator.hpp"
+
+
+static size_t column(const std::string& name) {
+    const auto& names = GenreFeatures::column_names();
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return i;
+    }
+    FAIL("no column " << name);
+    return 0;
+}
+
+
+// sustained A4 plus a decaying noise burst on every beat
+static std::vector<float> tone_with_clicks(uint32_t sample_rate, float seconds, float bpm) {
+    std::vector<float> samples(size_t(seconds * sample_rate));
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    const size_t beat = size_t(60.0f / bpm * sample_rate);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float click = std::exp(-float(i % beat) / (0.005f * sample_rate));
+        samples[i] = 0.3f * std::sin(2.0f * float(M_PI) * 440.0f * i / sample_rate) + 0.5f * click * noise(rng);
+    }
+    return samples;
+}
+
+
+/**
+ * the 57 values line up with the header of the training data
+ */
+TEST_CASE("GenreFeatures columns match data/audio_features.csv", "[genre]") {
+    std::ifstream csv("../data/audio_features.csv");
+    REQUIRE(csv.good());
+
+    std::string header;
+    std::getline(csv, header);
+    std::stringstream fields(header);
+    std::vector<std::string> names;
+    for (std::string field; std::getline(fields, field, ',');) names.push_back(field);
+
+    // filename and genre come first
+    REQUIRE(names.size() == GENRE_FEATURE_COUNT + 2);
+    for (size_t i = 0; i < GENRE_FEATURE_COUNT; ++i) {
+        CHECK(GenreFeatures::column_names()[i] == names[i + 2]);
+    }
+}
+
+
+/**
+ * a tone over a click track: pitch class, harmonic/percussive balance and tempo
+ */
+TEST_CASE("GenreFeatureExtractor describes a tone over a click track", "[genre]") {
+    GenreFeatureExtractor extractor;
+    const uint32_t sr = extractor.get_config().sample_rate;
+    std::vector<float> signal = tone_with_clicks(sr, 12.0f, 120.0f);
+
+    GenreFeatures features = extractor.extract(signal.data(), signal.size());
+    const auto& v = features.values;
+
+    INFO("tempo " << v[column("tempo")]);
+    CHECK(v[column("tempo")] == Approx(120.0f).epsilon(0.03));
+
+    // one pitch class at the peak, the others well below
+    CHECK(v[column("chroma_stft_mean")] > 1.0f / 12.0f);
+    CHECK(v[column("chroma_stft_mean")] < 0.5f);
+
+    CHECK(v[column("rms_mean")] > 0.2f);
+    CHECK(v[column("harmony_mean")] > v[column("perceptr_mean")]);
+    CHECK(v[column("perceptr_var")] > 0.0f);
+    CHECK(v[column("spectral_centroid_mean")] > 440.0f);
+    CHECK(v[column("rolloff_mean")] >= v[column("spectral_centroid_mean")]);
+    CHECK(v[column("zero_crossing_rate_mean")] > 2.0f * 440.0f / sr);
+    CHECK(v[column("mfcc1_mean")] < 0.0f);
+    CHECK(v[column("mfcc1_var")] > 0.0f);
+
+    // same clip, same row
+    GenreFeatures again = extractor.extract(signal.data(), signal.size());
+    CHECK(again.values == v);
+
+    GenreFeatures empty = extractor.extract(signal.data(), 0);
+    CHECK(empty.values[column("rms_mean")] == 0.0f);
+}
+
+
+/**
+ * any chunking gives the same row, and snapshots do not disturb the stream
+ */
+TEST_CASE("GenreFeatureExtractor streams in chunks", "[genre]") {
+    GenreFeatureExtractor whole;
+    const uint32_t sr = whole.get_config().sample_rate;
+    std::vector<float> signal = tone_with_clicks(sr, 3.0f, 100.0f);
+    GenreFeatures expected = whole.extract(signal.data(), signal.size());
+    CHECK(whole.frames_processed() == whole.frame_count(signal.size()));
+
+    GenreFeatureExtractor chunked;
+    size_t offset = 0;
+    for (size_t chunk : {1u, 511u, 4096u, 10000u}) {
+        while (offset < signal.size() / 2) {
+            size_t count = std::min(chunk, signal.size() - offset);
+            chunked.push(signal.data() + offset, count);
+            offset += count;
+        }
+    }
+    GenreFeatures partial = chunked.snapshot();
+    CHECK(partial.values[column("rms_mean")] > 0.0f);
+    CHECK(chunked.frames_processed() < whole.frames_processed());
+
+    chunked.push(signal.data() + offset, signal.size() - offset);
+    GenreFeatures actual = chunked.finish();
+    CHECK(actual.values == expected.values);
+    CHECK(chunked.snapshot().values == expected.values);
+    CHECK_THROWS(chunked.push(signal.data(), 1));
+}
+
+
+/**
+ * a pure tone is all harmonic and has no tempo evidence beyond the prior
+ */
+TEST_CASE("GenreFeatureExtractor separates a steady tone as harmonic", "[genre]") {
+    GenreFeatureExtractor extractor;
+    const uint32_t sr = extractor.get_config().sample_rate;
+    std::vector<float> tone(size_t(4 * sr));
+    for (size_t i = 0; i < tone.size(); ++i) tone[i] = 0.5f * std::sin(2.0f * float(M_PI) * 440.0f * i / sr);
+
+    GenreFeatures features = extractor.extract(tone.data(), tone.size());
+    const auto& v = features.values;
+
+    CHECK(v[column("harmony_mean")] == Approx(0.5f / std::sqrt(2.0f)).epsilon(0.1));
+    CHECK(v[column("perceptr_mean")] < 0.1f * v[column("harmony_mean")]);
+    CHECK(v[column("spectral_centroid_mean")] == Approx(440.0f).epsilon(0.1));
+    CHECK(v[column("zero_crossing_rate_mean")] == Approx(2.0f * 440.0f / sr).epsilon(0.05));
+}
@@ -0,0 +1,115 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "mfcc.hpp"
+
+
+/**
+ * the DCT matrix is scipy's orthonormal DCT-II with librosa's lifter applied
+ */
+TEST_CASE("MfccStage computes a liftered orthonormal DCT-II", "[mfcc]") {
+    MfccConfig config;
+    config.num_mels = 40;
+    config.num_coefficients = 13;
+    config.lifter = 22.0f;
+    MfccStage mfcc(config);
+
+    std::vector<float> log_mel(config.num_mels);
+    for (uint32_t m = 0; m < config.num_mels; ++m) {
+        log_mel[m] = -40.0f + 30.0f * std::sin(0.3f * m) + 0.5f * m;
+    }
+
+    std::vector<float> cepstrum(mfcc.frame_size());
+    REQUIRE(mfcc.push(log_mel.data(), cepstrum.data()));
+
+    const double M = config.num_mels;
+    for (uint32_t k = 0; k < config.num_coefficients; ++k) {
+        double sum = 0.0;
+        for (uint32_t m = 0; m < config.num_mels; ++m) {
+            sum += log_mel[m] * std::cos(M_PI * k * (m + 0.5) / M);
+        }
+        double expected = sum * std::sqrt((k == 0 ? 1.0 : 2.0) / M);
+        expected *= 1.0 + 11.0 * std::sin(M_PI * (k + 1) / 22.0);
+        REQUIRE(cepstrum[k] == Approx(expected).epsilon(1e-4).margin(1e-3));
+    }
+}
+
+
+/**
+ * deltas are the exact first and second time derivatives of a quadratic trajectory,
+ * and every pushed frame comes out once, in order, after flush()
+ * - the edge frames take the slope of the first / last window's fit, the derivative
+ *   at that window's centre (librosa.feature.delta, mode="interp")
+ */
+TEST_CASE("MfccStage deltas follow a quadratic trajectory", "[mfcc]") {
+    MfccConfig config;
+    config.num_mels = 16;
+    config.num_coefficients = 4;
+    config.deltas = true;
+    MfccStage mfcc(config);
+    const uint32_t lag = mfcc.latency_frames();
+    const size_t half = config.delta_width / 2;
+    REQUIRE(lag == 8);
+
+    // every mel band follows a + b t + c t^2, so every coefficient does too
+    const double a = 2.0, b = 0.5, c = -0.05;
+    const size_t frames = 30;
+    std::vector<float> log_mel(config.num_mels);
+    std::vector<float> out(mfcc.frame_size());
+    std::vector<std::vector<float>> emitted;
+
+    for (size_t t = 0; t < frames; ++t) {
+        for (uint32_t m = 0; m < config.num_mels; ++m) {
+            log_mel[m] = float((a + b * t + c * t * t) * (m + 1) / config.num_mels);
+        }
+        if (mfcc.push(log_mel.data(), out.data())) emitted.push_back(out);
+        REQUIRE(emitted.size() == (t >= lag ? t - lag + 1 : 0));
+    }
+    while (mfcc.flush(out.data())) emitted.push_back(out);
+    REQUIRE(emitted.size() == frames);
+
+    // coefficient 0 is sqrt(1/M) * sum over bands
+    double band_sum = 0.0;
+    for (uint32_t m = 0; m < config.num_mels; ++m) band_sum += double(m + 1) / config.num_mels;
+    const double scale = band_sum / std::sqrt(double(config.num_mels));
+
+    for (size_t t = 0; t < frames; ++t) {
+        const std::vector<float>& frame = emitted[t];
+        const double centre = double(std::clamp(t, half, frames - 1 - half));
+        INFO("frame " << t);
+        CHECK(frame[0] == Approx(scale * (a + b * t + c * t * t)).epsilon(1e-4));
+        CHECK(frame[4] == Approx(scale * (b + 2 * c * centre)).margin(1e-4));
+        CHECK(frame[8] == Approx(scale * 2 * c).margin(1e-4));
+    }
+}
+
+
+/**
+ * a stream shorter than the delta window still comes out whole, with zero deltas
+ */
+TEST_CASE("MfccStage short streams get zero deltas", "[mfcc]") {
+    MfccConfig config;
+    config.num_mels = 16;
+    config.num_coefficients = 4;
+    config.deltas = true;
+    MfccStage mfcc(config);
+
+    std::vector<float> log_mel(config.num_mels);
+    std::vector<float> out(mfcc.frame_size());
+    for (size_t t = 0; t < config.delta_width - 1; ++t) {
+        std::fill(log_mel.begin(), log_mel.end(), float(t));
+        REQUIRE_FALSE(mfcc.push(log_mel.data(), out.data()));
+    }
+
+    size_t emitted = 0;
+    while (mfcc.flush(out.data())) {
+        CHECK(out[0] == Approx(std::sqrt(double(config.num_mels)) * emitted));
+        CHECK(std::all_of(out.begin() + config.num_coefficients, out.end(), [](float v) { return v == 0.0f; }));
+        ++emitted;
+    }
+    CHECK(emitted == config.delta_width - 1);
+}
@@ -0,0 +1,142 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "resampler.hpp"
+
+static std::vector<float> make_sine(double frequency, uint32_t sample_rate, size_t frames, double amplitude = 0.5) {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = float(amplitude * std::sin(2.0 * M_PI * frequency * i / sample_rate));
+    }
+    return samples;
+}
+
+
+/**
+ * 48 kHz capture -> 22050 Hz CNN input: the ratio reduces to 147/320 and an in-band
+ * tone comes out at the same frequency, delayed by the filter's group delay
+ */
+TEST_CASE("PolyphaseResampler converts 48 kHz to 22050 Hz", "[resampler]") {
+    PolyphaseResampler resampler(ResamplerConfig{});
+    REQUIRE(resampler.upsample_factor() == 147);
+    REQUIRE(resampler.downsample_factor() == 320);
+
+    const size_t input_frames = 48000;
+    std::vector<float> input = make_sine(1000.0, 48000, input_frames);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+
+    CHECK(std::abs(double(output.size()) - 22050.0) <= 1.0);
+
+    const ResamplerConfig& config = resampler.get_config();
+    const double delay = (147.0 * config.taps_per_phase - 1.0) / (2.0 * 320.0);
+    float max_error = 0.0f;
+
+    for (size_t j = 4 * resampler.latency_frames(); j < output.size(); ++j) {
+        float expected = float(0.5 * std::sin(2.0 * M_PI * 1000.0 * (j - delay) / 22050.0));
+        max_error = std::max(max_error, std::abs(output[j] - expected));
+    }
+    CHECK(max_error < 1e-3f);
+}
+
+
+// RMS of a 48 kHz -> 22050 Hz resampled sine (amplitude 0.5) once the filter has settled
+static double resampled_rms(double frequency) {
+    PolyphaseResampler resampler(ResamplerConfig{});
+
+    std::vector<float> input = make_sine(frequency, 48000, 48000);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+
+    double energy = 0.0;
+    size_t settled = 4 * resampler.latency_frames();
+    for (size_t j = settled; j < output.size(); ++j) {
+        energy += double(output[j]) * output[j];
+    }
+    return std::sqrt(energy / (output.size() - settled));
+}
+
+
+/**
+ * content above the output Nyquist frequency is filtered, not aliased; 12 kHz would
+ * fold to 10050 Hz, right next to the passband
+ */
+TEST_CASE("PolyphaseResampler rejects content above the output Nyquist", "[resampler]") {
+    const double full_scale = 0.5 / std::sqrt(2.0);
+    for (double frequency : {11500.0, 12000.0, 15000.0}) {
+        INFO(frequency << " Hz");
+        CHECK(20.0 * std::log10(resampled_rms(frequency) / full_scale) < -75.0);
+    }
+}
+
+
+/**
+ * the transition band sits between 9.5 kHz and the output Nyquist
+ */
+TEST_CASE("PolyphaseResampler passband is flat to 9.5 kHz", "[resampler]") {
+    const double full_scale = 0.5 / std::sqrt(2.0);
+    for (double frequency : {5000.0, 9000.0, 9500.0}) {
+        INFO(frequency << " Hz");
+        CHECK(std::abs(20.0 * std::log10(resampled_rms(frequency) / full_scale)) < 0.05);
+    }
+}
+
+
+/**
+ * the stream state carries over, so chunked and one-shot input give identical output
+ */
+TEST_CASE("PolyphaseResampler is independent of chunking", "[resampler]") {
+    ResamplerConfig config;
+    config.input_rate = 44100;
+    config.output_rate = 48000;
+
+    std::vector<float> input = make_sine(440.0, 44100, 10000);
+
+    PolyphaseResampler whole(config);
+    std::vector<float> expected;
+    whole.process(input.data(), input.size(), expected);
+
+    PolyphaseResampler chunked(config);
+    std::vector<float> output;
+    size_t offset = 0;
+    size_t chunk = 1;
+    while (offset < input.size()) {
+        size_t frames = std::min(chunk, input.size() - offset);
+        chunked.process(input.data() + offset, frames, output);
+        offset += frames;
+        chunk = chunk * 3 + 1;
+    }
+
+    CHECK(output == expected);
+}
+
+
+/**
+ * flush() pushes the last input through every tap and starts a new stream
+ */
+TEST_CASE("PolyphaseResampler flush emits the filter tail", "[resampler]") {
+    PolyphaseResampler resampler(ResamplerConfig{});
+    std::vector<float> input = make_sine(1000.0, 48000, 4800);
+
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+    size_t tail = resampler.flush(output);
+
+    // the full convolution: (input + taps - 1) samples at the upsampled rate, every M-th kept
+    const ResamplerConfig& config = resampler.get_config();
+    const double expected = double(input.size() + config.taps_per_phase - 1) * 147.0 / 320.0;
+    CHECK(std::abs(double(output.size()) - expected) <= 1.0);
+    CHECK(tail >= resampler.latency_frames());
+
+    // the tone is still present just before the tail, the filter has fully decayed at its end
+    CHECK(std::abs(output[output.size() - tail - 1]) > 0.0f);
+    CHECK(std::abs(output.back()) < 1e-3f);
+
+    std::vector<float> again;
+    resampler.process(input.data(), input.size(), again);
+    CHECK(std::equal(again.begin(), again.end(), output.begin()));
+}
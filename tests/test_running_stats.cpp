@@ -0,0 +1,95 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "running_stats.hpp"
+
+
+static constexpr size_t DIMS = 37;     // odd, so every vector width runs its scalar tail
+
+static std::vector<float> random_frames(size_t frames, float offset, float spread, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, spread);
+
+    std::vector<float> values(frames * DIMS);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = offset * float(1 + i % DIMS) + dist(rng);
+    return values;
+}
+
+
+static void two_pass(const std::vector<float>& values, size_t frames, size_t dim, double& mean, double& var) {
+    mean = 0.0;
+    for (size_t t = 0; t < frames; ++t) mean += values[t * DIMS + dim];
+    mean /= frames;
+    var = 0.0;
+    for (size_t t = 0; t < frames; ++t) var += (values[t * DIMS + dim] - mean) * (values[t * DIMS + dim] - mean);
+    var /= frames;
+}
+
+
+/**
+ * Welford stays accurate where a float sum of squares would cancel
+ */
+TEST_CASE("RunningStats matches a double two-pass reference", "[stats]") {
+    const size_t frames = 20000;
+    std::vector<float> values = random_frames(frames, 1000.0f, 0.5f, 1);
+
+    RunningStats stats(DIMS);
+    for (size_t t = 0; t < frames; ++t) stats.push(values.data() + t * DIMS);
+    REQUIRE(stats.count() == frames);
+
+    for (size_t d = 0; d < DIMS; ++d) {
+        double mean, var;
+        two_pass(values, frames, d, mean, var);
+        CHECK(stats.mean()[d] == Approx(mean).epsilon(1e-6));
+        CHECK(stats.variance(d) == Approx(var).epsilon(1e-3));
+        CHECK(stats.variance(d, 1) == Approx(var * frames / (frames - 1)).epsilon(1e-3));
+    }
+}
+
+
+/**
+ * partial statistics merge into the statistics of the whole stream
+ */
+TEST_CASE("RunningStats merge and pooled statistics", "[stats]") {
+    const size_t frames = 3000;
+    std::vector<float> values = random_frames(frames, 3.0f, 2.0f, 2);
+
+    RunningStats whole(DIMS), first(DIMS), second(DIMS), empty(DIMS);
+    for (size_t t = 0; t < frames; ++t) {
+        whole.push(values.data() + t * DIMS);
+        (t < 1234 ? first : second).push(values.data() + t * DIMS);
+    }
+    first.merge(second);
+    first.merge(empty);
+    empty.merge(whole);
+
+    REQUIRE(first.count() == frames);
+    REQUIRE(empty.count() == frames);
+    for (size_t d = 0; d < DIMS; ++d) {
+        CHECK(first.mean()[d] == Approx(whole.mean()[d]).epsilon(1e-5));
+        CHECK(first.variance(d) == Approx(whole.variance(d)).epsilon(1e-4));
+        CHECK(empty.variance(d) == whole.variance(d));
+    }
+
+    // every value as one population
+    double sum = 0.0, squares = 0.0;
+    for (float v : values) sum += v;
+    const double mean = sum / values.size();
+    for (float v : values) squares += (v - mean) * (v - mean);
+
+    float pooled_mean, pooled_var;
+    whole.pooled(pooled_mean, pooled_var);
+    CHECK(pooled_mean == Approx(mean).epsilon(1e-5));
+    CHECK(pooled_var == Approx(squares / values.size()).epsilon(1e-4));
+
+    RunningStats scalar;
+    for (float v : {1.0f, 2.0f, 3.0f, 4.0f}) scalar.push(v);
+    CHECK(scalar.mean()[0] == 2.5f);
+    CHECK(scalar.variance(0) == 1.25f);
+
+    CHECK_THROWS_AS(scalar.merge(whole), std::invalid_argument);
+}
@@ -0,0 +1,120 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "simd_kernels.hpp"
+
+using simd::Isa;
+
+// odd length so every vector width also runs its scalar tail
+static constexpr size_t N = 1037;
+
+static std::vector<float> random_samples(size_t count, float low, float high, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(low, high);
+
+    std::vector<float> samples(count);
+    for (float& v : samples) v = dist(rng);
+    return samples;
+}
+
+
+/**
+ * every table this CPU can run must agree with the scalar reference loops
+ */
+TEST_CASE("simd kernels match the scalar reference on every supported ISA", "[simd]") {
+    const Isa original = simd::active_isa();
+
+    for (Isa isa : {Isa::scalar, Isa::sse2, Isa::avx2, Isa::avx512, Isa::neon}) {
+        if (!simd::isa_supported(isa)) continue;
+
+        DYNAMIC_SECTION("isa " << simd::isa_name(isa)) {
+            REQUIRE(simd::set_isa(isa));
+            REQUIRE(simd::active_isa() == isa);
+
+            std::vector<float> a = random_samples(4 * N, -1.0f, 1.0f, 1);
+            std::vector<float> b = random_samples(4 * N, -1.0f, 1.0f, 2);
+
+            for (uint32_t channels : {2u, 3u, 4u}) {
+                std::vector<float> weights = random_samples(channels, 0.0f, 1.0f, channels);
+                std::vector<float> expected(N), actual(N);
+                simd::detail::scalar_downmix(a.data(), N, channels, weights.data(), expected.data());
+                simd::downmix(a.data(), N, channels, weights.data(), actual.data());
+                for (size_t i = 0; i < N; ++i) REQUIRE(actual[i] == Approx(expected[i]).margin(1e-6));
+
+                std::vector<std::vector<float>> planes(channels, std::vector<float>(N));
+                std::vector<float*> outs(channels);
+                for (uint32_t c = 0; c < channels; ++c) outs[c] = planes[c].data();
+                simd::deinterleave(a.data(), N, channels, outs.data());
+                for (uint32_t c = 0; c < channels; ++c) {
+                    for (size_t i = 0; i < N; ++i) REQUIRE(planes[c][i] == a[i * channels + c]);
+                }
+            }
+
+            CHECK(simd::dot(a.data(), b.data(), N) == Approx(simd::detail::scalar_dot(a.data(), b.data(), N)).margin(1e-4));
+
+            std::vector<float> expected(N), actual(N);
+            float expected_abs = simd::detail::scalar_apply_window(a.data(), b.data(), expected.data(), N);
+            float actual_abs = simd::apply_window(a.data(), b.data(), actual.data(), N);
+            CHECK(actual_abs == Approx(expected_abs).epsilon(1e-5));
+            CHECK(actual == expected);
+
+            simd::detail::scalar_power_spectrum(a.data(), N, expected.data());
+            simd::power_spectrum(a.data(), N, actual.data());
+            for (size_t i = 0; i < N; ++i) REQUIRE(actual[i] == Approx(expected[i]).epsilon(1e-6).margin(1e-12));
+
+            // power spanning the whole dynamic range the extractor produces
+            std::vector<float> power(N);
+            for (size_t i = 0; i < N; ++i) power[i] = std::pow(10.0f, -12.0f + 18.0f * float(i) / N) * (1.0f + 0.5f * b[i]);
+
+            float expected_max = simd::detail::scalar_power_to_db(power.data(), N, 1e-10f, expected.data());
+            float actual_max = simd::power_to_db(power.data(), N, 1e-10f, actual.data());
+            CHECK(actual_max == Approx(expected_max).margin(1e-4));
+            for (size_t i = 0; i < N; ++i) REQUIRE(actual[i] == Approx(expected[i]).margin(1e-4));
+
+            std::vector<float> freqs(N);
+            for (size_t k = 0; k < N; ++k) freqs[k] = 24000.0f * float(k) / N;
+            power[0] = 0.0f;    // sqrt(0) and the amin floor
+
+            simd::SpectralSums expected_sums = simd::detail::scalar_spectral_sums(power.data(), freqs.data(), N, 1e-10f, expected.data());
+            simd::SpectralSums actual_sums = simd::spectral_sums(power.data(), freqs.data(), N, 1e-10f, actual.data());
+            for (size_t i = 0; i < N; ++i) REQUIRE(actual[i] == Approx(expected[i]).epsilon(1e-6));
+            CHECK(actual_sums.magnitude == Approx(expected_sums.magnitude).epsilon(1e-4));
+            CHECK(actual_sums.weighted_freq == Approx(expected_sums.weighted_freq).epsilon(1e-4));
+            CHECK(actual_sums.power == Approx(expected_sums.power).epsilon(1e-4));
+            CHECK(actual_sums.log_power == Approx(expected_sums.log_power).epsilon(1e-4));
+
+            std::vector<double> expected_mean(N, 0.0), expected_m2(N, 0.0), actual_mean(N, 0.0), actual_m2(N, 0.0);
+            for (uint32_t count = 1; count <= 4; ++count) {
+                const float* x = a.data() + (count - 1) * N;
+                simd::detail::scalar_welford_update(x, N, 1.0 / count, expected_mean.data(), expected_m2.data());
+                simd::welford_update(x, N, 1.0 / count, actual_mean.data(), actual_m2.data());
+            }
+            for (size_t i = 0; i < N; ++i) {
+                REQUIRE(actual_mean[i] == Approx(expected_mean[i]).margin(1e-12));
+                REQUIRE(actual_m2[i] == Approx(expected_m2[i]).margin(1e-12));
+            }
+        }
+    }
+
+    simd::set_isa(original);
+}
+
+
+/**
+ * forcing a table the CPU cannot run is refused and leaves the active table alone
+ */
+TEST_CASE("simd dispatch only selects supported tables", "[simd]") {
+    const Isa original = simd::active_isa();
+    REQUIRE(simd::isa_supported(original));
+    REQUIRE(simd::isa_supported(Isa::scalar));
+
+    for (Isa isa : {Isa::sse2, Isa::avx2, Isa::avx512, Isa::neon}) {
+        if (simd::isa_supported(isa)) continue;
+        CHECK_FALSE(simd::set_isa(isa));
+        CHECK(simd::active_isa() == original);
+    }
+}
@@ -0,0 +1,95 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+/**
+ * capacity is rounded to a power of two and views never need a copy
+ */
+TEST_CASE("SpscRing views are contiguous across the wrap", "[ring]") {
+    SpscRing ring;
+    REQUIRE(ring.init(100, 16));
+    CHECK(ring.capacity() == 128);
+
+    std::vector<float> block(48);
+    float next = 0.0f;
+
+    // walk the ring several times with a block size that does not divide the capacity
+    for (int round = 0; round < 20; ++round) {
+        std::iota(block.begin(), block.end(), next);
+        next += block.size();
+        REQUIRE(ring.write(block.data(), block.size()) == block.size());
+
+        for (int i = 0; i < 3; ++i) {
+            std::span<const float> view = ring.read_view(16);
+            REQUIRE(view.size() == 16);
+
+            float expected = float(ring.read_position());
+            for (float v : view) {
+                CHECK(v == expected++);
+            }
+            ring.consume(16);
+        }
+    }
+
+    CHECK(ring.available_read() == 0);
+}
+
+
+TEST_CASE("SpscRing refuses oversized views and reports overruns", "[ring]") {
+    SpscRing ring;
+    REQUIRE(ring.init(64, 32));
+
+    std::vector<float> block(100, 1.0f);
+    CHECK(ring.write(block.data(), block.size()) == 64);
+    CHECK(ring.available_write() == 0);
+
+    CHECK(ring.read_view(33).empty());
+    CHECK(ring.read_view(32).size() == 32);
+
+    // copying reads are not limited by the mirror size
+    std::vector<float> out(64);
+    CHECK(ring.read(out.data(), out.size()) == 64);
+    CHECK(ring.available_read() == 0);
+}
+
+
+TEST_CASE("SpscRing delivers every sample in order across threads", "[ring]") {
+    SpscRing ring;
+    REQUIRE(ring.init(256, 64));
+
+    const size_t total = 1 << 18;     // multiple of the view size
+
+    std::thread producer([&] {
+        std::vector<float> block(37);
+        size_t sent = 0;
+        while (sent < total) {
+            size_t n = std::min(block.size(), total - sent);
+            for (size_t i = 0; i < n; ++i) block[i] = float(sent + i);
+
+            size_t written = 0;
+            while (written < n) {
+                written += ring.write(block.data() + written, n - written);
+            }
+            sent += n;
+        }
+    });
+
+    size_t received = 0;
+    bool in_order = true;
+    while (received < total) {
+        std::span<const float> view = ring.read_view(64);
+        if (view.empty()) continue;
+        for (float v : view) {
+            in_order = in_order && (v == float(received++));
+        }
+        ring.consume(view.size());
+    }
+
+    producer.join();
+    CHECK(in_order);
+}